@@ -0,0 +1,195 @@
+#ifndef ALPHA_SHAPE_H
+#define ALPHA_SHAPE_H
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include "point.h"
+#include "circle.h"
+#include "polygon.h"
+#include "triangle_mesh.h"
+#include "delaunay.h"
+#include "parallel.h"
+
+namespace geometry {
+
+// concave hulls of the points of Delaunay triangulation
+// circumradii of all triangles are found once, so shapes for any alpha are taken
+// from the prefix of triangles sorted by radius without touching the mesh again
+// boundaries are returned as rings: outer rings are counterclockwise, holes are clockwise
+// `mesh` must outlive the shape
+template<typename Tp, typename Index = uint32_t>
+class AlphaShape {
+private:
+    typedef Point<Tp, 2> Pnt;
+    typedef TriangleMesh<Index> Mesh;
+
+public:
+    static const Index NONE = Mesh::NONE;
+
+public:
+    explicit AlphaShape(const Delaunay<Tp, Index>& mesh, size_t threads = 1)
+        : mesh_(mesh)
+        , topology_(mesh.GetMesh())
+    {
+        size_t count = topology_.TrianglesCount();
+        radii_.resize(count);
+        ParallelFor(count, threads, [this] (size_t t) {
+            radii_[t] = Circumradius(mesh_.GetPoint(topology_.Vertex(t, 0)),
+                                     mesh_.GetPoint(topology_.Vertex(t, 1)),
+                                     mesh_.GetPoint(topology_.Vertex(t, 2)));
+        });
+
+        order_.resize(count);
+        for (size_t t = 0; t < count; ++t)
+            order_[t] = static_cast<Index>(t);
+        ParallelSort(order_.begin(), order_.end(), [this] (Index a, Index b) {
+            return radii_[a] < radii_[b];
+        }, threads);
+    }
+
+    // count of triangles with circumradius <= `alpha`, they are Triangle(0), Triangle(1), ...
+    size_t TrianglesCount(double alpha) const {
+        return std::upper_bound(order_.begin(), order_.end(), alpha, [this] (double r, Index t) {
+            return r < radii_[t];
+        }) - order_.begin();
+    }
+
+    Index Triangle(size_t i) const {
+        return order_[i];
+    }
+
+    double Radius(Index t) const {
+        return radii_[t];
+    }
+
+    // boundary of the union of triangles with circumradius <= `alpha`
+    std::vector<Polygon<Tp>> Rings(double alpha) const {
+        std::vector<char> alive(topology_.TrianglesCount(), 0);
+        size_t count = TrianglesCount(alpha);
+        for (size_t i = 0; i < count; ++i)
+            alive[order_[i]] = 1;
+
+        return Boundary(alive);
+    }
+
+    // rings of every alpha of `alphas`, shapes are built in parallel
+    std::vector<std::vector<Polygon<Tp>>> Rings(const std::vector<double>& alphas,
+                                                size_t threads = 1) const
+    {
+        std::vector<std::vector<Polygon<Tp>>> res(alphas.size());
+        ParallelFor(alphas.size(), threads, [&] (size_t i) {
+            res[i] = Rings(alphas[i]);
+        });
+        return res;
+    }
+
+    // chi-shape (Duckham et al.): starting from the convex hull, removes triangles through
+    // their longest boundary edge while it is longer than `length` and the third vertex
+    // of the triangle isn't on the boundary yet, so the shape stays one simple polygon
+    Polygon<Tp> ChiShape(double length) const {
+        struct Item {
+            double length;
+            Index h;
+
+            bool operator<(const Item& oth) const {
+                return length < oth.length;
+            }
+        };
+
+        size_t count = topology_.TrianglesCount();
+        std::vector<char> alive(count, 1);
+        std::vector<char> on_boundary(mesh_.PointsCount(), 0);
+        std::priority_queue<Item> heap;
+        for (Index h = 0; h < 3 * count; ++h) {
+            if (topology_.Twin(h) == NONE) {
+                on_boundary[topology_.Origin(h)] = 1;
+                heap.push(Item{Length(h), h});
+            }
+        }
+
+        while (!heap.empty() && heap.top().length > length) {
+            Index h = heap.top().h;
+            heap.pop();
+            if (!alive[h / 3])
+                continue;
+
+            Index far = topology_.Origin(Mesh::Prev(h));
+            if (on_boundary[far])
+                continue;
+
+            alive[h / 3] = 0;
+            on_boundary[far] = 1;
+            for (Index e: {Mesh::Next(h), Mesh::Prev(h)}) {
+                Index twin = topology_.Twin(e);
+                heap.push(Item{Length(twin), twin});
+            }
+        }
+
+        std::vector<Polygon<Tp>> rings = Boundary(alive);
+        assert(rings.size() <= 1);
+        return rings.empty() ? Polygon<Tp>() : rings[0];
+    }
+
+private:
+    Point<double> Convert(Index v) const {
+        const Pnt& p = mesh_.GetPoint(v);
+        return Point<double>(static_cast<double>(p.x()), static_cast<double>(p.y()));
+    }
+
+    double Length(Index h) const {
+        return Convert(topology_.Origin(h)).Distance(Convert(topology_.Target(h)));
+    }
+
+    bool IsBoundary(const std::vector<char>& alive, Index h) const {
+        Index twin = topology_.Twin(h);
+        return twin == NONE || !alive[twin / 3];
+    }
+
+    // chains boundary half-edges of alive triangles, the shape is on the left of every ring
+    // at a vertex shared by several fans the ring turns into the fan it came from
+    std::vector<Polygon<Tp>> Boundary(const std::vector<char>& alive) const {
+        std::vector<char> used(3 * alive.size(), 0);
+        std::vector<Polygon<Tp>> res;
+        std::vector<Pnt> ring;
+
+        for (Index t = 0; t < alive.size(); ++t) {
+            if (!alive[t])
+                continue;
+
+            for (Index start = 3 * t; start < 3 * t + 3; ++start) {
+                if (used[start] || !IsBoundary(alive, start))
+                    continue;
+
+                ring.clear();
+                Index h = start;
+                do {
+                    used[h] = 1;
+                    ring.push_back(mesh_.GetPoint(topology_.Origin(h)));
+
+                    h = Mesh::Next(h);
+                    while (!IsBoundary(alive, h))
+                        h = Mesh::Next(topology_.Twin(h));
+                } while (h != start);
+
+                res.push_back(Polygon<Tp>(std::vector<Pnt>(ring)));
+            }
+        }
+
+        return res;
+    }
+
+private:
+    const Delaunay<Tp, Index>& mesh_;
+    const Mesh& topology_;
+    std::vector<double> radii_;
+    std::vector<Index> order_;
+};
+
+template<typename Tp, typename Index>
+const Index AlphaShape<Tp, Index>::NONE;
+
+} // namespace geometry
+
+#endif // ALPHA_SHAPE_H
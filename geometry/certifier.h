@@ -0,0 +1,329 @@
+#ifndef CERTIFIER_H
+#define CERTIFIER_H
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <cmath>
+#include <cstdint>
+#include "point.h"
+#include "predicates.h"
+#include "triangle_mesh.h"
+#include "delaunay.h"
+#include "parallel.h"
+
+namespace geometry {
+
+// defects found by `CertifyDelaunay`, the mesh is a Delaunay triangulation if there are none
+template<typename Index = uint32_t>
+struct MeshCertificate {
+    size_t bad_links;     // half-edges with a wrong twin or vertex, vertices with a wrong edge
+    size_t inverted;      // triangles, which aren't strictly counterclockwise
+    size_t reflex;        // boundary corners turning right
+    size_t not_delaunay;  // interior edges with the far vertex strictly inside the circle
+    size_t not_disk;      // 1 if the boundary isn't one loop or the count of triangles isn't
+                          // the one of a triangulated disk
+    Index first;          // the first triangle with a local defect, NONE if there is none
+
+    bool Valid() const {
+        return bad_links == 0 && inverted == 0 && reflex == 0 && not_delaunay == 0 && not_disk == 0;
+    }
+};
+
+namespace detail {
+
+// predicates on double coordinates with the error bounds of Shewchuk's stage A,
+// `Orientation` and `InCircle` decide only the signs within the bound
+// coordinates must convert to double exactly
+template<typename Tp>
+struct CertifierFilter {
+    static const bool ENABLED = std::is_floating_point<Tp>::value ? sizeof(Tp) <= sizeof(double)
+                                                                  : sizeof(Tp) <= 4;
+};
+
+inline double OrientationBound(double ax, double ay, double bx, double by, double cx, double cy,
+                               double& det)
+{
+    double left = (ax - cx) * (by - cy);
+    double right = (ay - cy) * (bx - cx);
+    det = left - right;
+    return 3.3306690738754716e-16 * (std::abs(left) + std::abs(right));
+}
+
+inline double InCircleBound(double ax, double ay, double bx, double by, double cx, double cy,
+                            double dx, double dy, double& det)
+{
+    double adx = ax - dx, ady = ay - dy;
+    double bdx = bx - dx, bdy = by - dy;
+    double cdx = cx - dx, cdy = cy - dy;
+
+    double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    double cdxady = cdx * ady, adxcdy = adx * cdy;
+    double adxbdy = adx * bdy, bdxady = bdx * ady;
+    double alift = adx * adx + ady * ady;
+    double blift = bdx * bdx + bdy * bdy;
+    double clift = cdx * cdx + cdy * cdy;
+
+    det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+    double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * alift +
+                       (std::abs(cdxady) + std::abs(adxcdy)) * blift +
+                       (std::abs(adxbdy) + std::abs(bdxady)) * clift;
+    return 1.1102230246251577e-15 * permanent;
+}
+
+// true if the boundary of a mesh with valid links is one loop and the count of triangles
+// is the one of a triangulated disk: 2 * vertices - 2 - boundary vertices
+template<typename Index>
+bool IsDisk(const TriangleMesh<Index>& mesh) {
+    const Index NONE = TriangleMesh<Index>::NONE;
+
+    std::vector<Index> out(mesh.VerticesCount(), NONE);
+    std::vector<char> used(mesh.VerticesCount(), 0);
+    size_t boundary = 0;
+    Index start = NONE;
+    for (size_t h = 0; h < mesh.Triangles().size(); ++h) {
+        used[mesh.Origin(h)] = 1;
+        if (mesh.Twin(h) != NONE)
+            continue;
+        if (out[mesh.Origin(h)] != NONE)
+            return false;
+        out[mesh.Origin(h)] = static_cast<Index>(h);
+        start = static_cast<Index>(h);
+        ++boundary;
+    }
+    if (start == NONE)
+        return false;
+
+    size_t steps = 0;
+    Index h = start;
+    do {
+        h = out[mesh.Target(h)];
+        ++steps;
+    } while (h != NONE && h != start && steps <= boundary);
+    if (h != start || steps != boundary)
+        return false;
+
+    size_t vertices = std::count(used.begin(), used.end(), 1);
+    return mesh.TrianglesCount() + 2 + boundary == 2 * vertices;
+}
+
+} // namespace detail
+
+// checks in one parallel pass over triangles, that
+// - twins are the same edges backwards, vertex ids and vertex edges are in range and consistent
+// - every triangle is strictly counterclockwise
+// - the boundary is convex
+// - every interior edge is locally Delaunay
+// and then in one sequential pass, that the boundary is one loop and
+// triangles == 2 * vertices - 2 - boundary vertices, counting only vertices of triangles,
+// so the mesh is a triangulated disk
+// together they mean, that the mesh is a Delaunay triangulation of the vertices
+// of its triangles; the signs are exact for floating point coordinates and for integer
+// ones in the range of `InCircle`
+//
+// blocks of triangles are taken by `threads` dynamically; coordinates of a block are gathered
+// into flat arrays first, so the filtered predicates run as straight loops the compiler
+// vectorizes, and only the few uncertain signs go to `Orientation` and `InCircle`
+template<typename Tp, typename Index>
+MeshCertificate<Index> CertifyDelaunay(const std::vector<Point<Tp, 2>>& points,
+                                       const TriangleMesh<Index>& mesh, size_t threads = 1)
+{
+    typedef TriangleMesh<Index> Mesh;
+    const Index NONE = Mesh::NONE;
+    const size_t GRAIN = 4096;
+    const bool FILTER = detail::CertifierFilter<Tp>::ENABLED;
+
+    struct State {
+        MeshCertificate<Index> res;
+        std::vector<double> coords;
+        std::vector<double> dets;
+        std::vector<double> bounds;
+        std::vector<Index> edges;
+        std::vector<Index> fars;
+        std::vector<char> linked;
+    };
+
+    size_t count = mesh.TrianglesCount();
+    size_t half_edges = 3 * count;
+    size_t vertices = std::min(mesh.VerticesCount(), points.size());
+    std::vector<State> states(ThreadsCount(threads, (count + GRAIN - 1) / GRAIN));
+    for (auto& state: states)
+        state.res = MeshCertificate<Index>{0, 0, 0, 0, 0, NONE};
+
+    auto report = [] (MeshCertificate<Index>& res, size_t& counter, size_t t) {
+        ++counter;
+        res.first = std::min(res.first, static_cast<Index>(t));
+    };
+
+    ParallelBlocks(count, threads, GRAIN, [&] (size_t thread, size_t begin, size_t end) {
+        State& state = states[thread];
+        MeshCertificate<Index>& res = state.res;
+        state.edges.clear();
+        state.fars.clear();
+        state.linked.assign(end - begin, 1);
+        std::vector<char>& linked = state.linked;
+
+        // links; triangles with a vertex out of range aren't checked further
+        for (size_t t = begin; t < end; ++t) {
+            bool ok = true;
+            for (size_t h = 3 * t; h < 3 * t + 3; ++h) {
+                Index twin = mesh.Twin(h);
+                if (mesh.Origin(h) >= vertices) {
+                    linked[t - begin] = 0;
+                    ok = false;
+                } else if (twin != NONE && (twin >= half_edges || twin / 3 == t ||
+                                            mesh.Twin(twin) != h ||
+                                            mesh.Origin(twin) != mesh.Target(h) ||
+                                            mesh.Target(twin) != mesh.Origin(h))) {
+                    ok = false;
+                }
+            }
+            if (!ok) {
+                report(res, res.bad_links, t);
+                continue;
+            }
+
+            // every interior edge once, from its smaller half-edge
+            for (size_t h = 3 * t; h < 3 * t + 3; ++h) {
+                Index twin = mesh.Twin(h);
+                if (twin != NONE && h < twin && mesh.Origin(Mesh::Prev(twin)) < vertices) {
+                    state.edges.push_back(static_cast<Index>(h));
+                    state.fars.push_back(mesh.Origin(Mesh::Prev(twin)));
+                }
+            }
+        }
+
+        // orientation of triangles
+        size_t block = end - begin;
+        if (FILTER) {
+            state.coords.resize(6 * block);
+            state.dets.resize(block);
+            state.bounds.resize(block);
+            for (size_t i = 0; i < block; ++i) {
+                for (size_t k = 0; k < 3; ++k) {
+                    Index v = mesh.Vertex(begin + i, k);
+                    state.coords[6 * i + 2 * k] = linked[i] ? static_cast<double>(points[v].x()) : 0;
+                    state.coords[6 * i + 2 * k + 1] = linked[i] ? static_cast<double>(points[v].y()) : 0;
+                }
+            }
+
+            const double* c = state.coords.data();
+            double* dets = state.dets.data();
+            double* bounds = state.bounds.data();
+            for (size_t i = 0; i < block; ++i) {
+                const double* p = c + 6 * i;
+                bounds[i] = detail::OrientationBound(p[0], p[1], p[2], p[3], p[4], p[5], dets[i]);
+            }
+        }
+
+        for (size_t i = 0; i < block; ++i) {
+            if (!linked[i])
+                continue;
+
+            size_t t = begin + i;
+            int sign;
+            if (FILTER && state.dets[i] > state.bounds[i])
+                sign = 1;
+            else if (FILTER && -state.dets[i] > state.bounds[i])
+                sign = -1;
+            else
+                sign = Orientation(points[mesh.Vertex(t, 0)], points[mesh.Vertex(t, 1)],
+                                   points[mesh.Vertex(t, 2)]);
+            if (sign <= 0)
+                report(res, res.inverted, t);
+        }
+
+        // convexity of the boundary, walks around corners stop at broken twins
+        for (size_t t = begin; t < end; ++t) {
+            if (!linked[t - begin])
+                continue;
+            for (size_t h = 3 * t; h < 3 * t + 3; ++h) {
+                if (mesh.Twin(h) != NONE)
+                    continue;
+
+                Index e = Mesh::Next(h);
+                size_t steps = 0;
+                while (e < half_edges && mesh.Twin(e) != NONE && steps++ < half_edges)
+                    e = Mesh::Next(mesh.Twin(e));
+                if (e >= half_edges || mesh.Twin(e) != NONE || mesh.Target(e) >= vertices)
+                    continue;
+
+                if (Orientation(points[mesh.Origin(h)], points[mesh.Target(h)], points[mesh.Target(e)]) < 0)
+                    report(res, res.reflex, t);
+            }
+        }
+
+        // incircle of interior edges
+        size_t edges = state.edges.size();
+        if (FILTER) {
+            state.coords.resize(8 * edges);
+            state.dets.resize(edges);
+            state.bounds.resize(edges);
+            for (size_t i = 0; i < edges; ++i) {
+                Index h = state.edges[i];
+                Index v[4] = {mesh.Origin(h), mesh.Target(h), mesh.Origin(Mesh::Prev(h)), state.fars[i]};
+                for (size_t k = 0; k < 4; ++k) {
+                    state.coords[8 * i + 2 * k] = static_cast<double>(points[v[k]].x());
+                    state.coords[8 * i + 2 * k + 1] = static_cast<double>(points[v[k]].y());
+                }
+            }
+
+            const double* c = state.coords.data();
+            double* dets = state.dets.data();
+            double* bounds = state.bounds.data();
+            for (size_t i = 0; i < edges; ++i) {
+                const double* p = c + 8 * i;
+                bounds[i] = detail::InCircleBound(p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7], dets[i]);
+            }
+        }
+
+        for (size_t i = 0; i < edges; ++i) {
+            if (FILTER && state.dets[i] < -state.bounds[i])
+                continue;
+
+            Index h = state.edges[i];
+            size_t t = h / 3;
+            if ((FILTER && state.dets[i] > state.bounds[i]) ||
+                InCircle(points[mesh.Origin(h)], points[mesh.Target(h)],
+                         points[mesh.Origin(Mesh::Prev(h))], points[state.fars[i]]) > 0)
+                report(res, res.not_delaunay, t);
+        }
+    });
+
+    MeshCertificate<Index> res{0, 0, 0, 0, 0, NONE};
+    for (const auto& state: states) {
+        res.bad_links += state.res.bad_links;
+        res.inverted += state.res.inverted;
+        res.reflex += state.res.reflex;
+        res.not_delaunay += state.res.not_delaunay;
+        res.first = std::min(res.first, state.res.first);
+    }
+
+    // vertex edges must start at their vertices
+    std::vector<size_t> bad_vertices(ThreadsCount(threads, vertices), 0);
+    ParallelChunks(vertices, bad_vertices.size(), [&] (size_t chunk, size_t begin, size_t end) {
+        for (size_t v = begin; v < end; ++v) {
+            Index h = mesh.VertexEdge(v);
+            if (h != NONE && (h >= half_edges || mesh.Origin(h) != v))
+                ++bad_vertices[chunk];
+        }
+    });
+    for (size_t bad: bad_vertices)
+        res.bad_links += bad;
+    if (mesh.VerticesCount() > points.size())
+        res.bad_links += mesh.VerticesCount() - points.size();
+
+    // local checks pass for several disjoint or overlapping triangulations too,
+    // the topology is checked as a whole by one pass over boundary edges
+    if (res.bad_links == 0 && count > 0)
+        res.not_disk = detail::IsDisk(mesh) ? 0 : 1;
+    return res;
+}
+
+template<typename Tp, typename Index>
+MeshCertificate<Index> CertifyDelaunay(const Delaunay<Tp, Index>& delaunay, size_t threads = 1) {
+    return CertifyDelaunay(delaunay.Points(), delaunay.GetMesh(), threads);
+}
+
+} // namespace geometry
+
+#endif // CERTIFIER_H
@@ -10,6 +10,7 @@
 #include <list>
 #include <iterator>
 #include <unordered_map>
+#include <limits>
 #include "point.h"
 #include "vector.h"
 #include "circular_list.h"
@@ -17,6 +18,38 @@
 
 namespace geometry {
 
+namespace detail {
+
+// offset of the center of the circle through `a`, `b`, `c` from `a`, it's computed in double
+// from the differences, so small triangles far from the origin keep their precision;
+// the offset isn't finite for collinear points
+template<typename Tp>
+Point<double> CircumcenterOffset(const Point<Tp, 2>& a, const Point<Tp, 2>& b, const Point<Tp, 2>& c) {
+    double bx = static_cast<double>(b.x()) - a.x(), by = static_cast<double>(b.y()) - a.y();
+    double cx = static_cast<double>(c.x()) - a.x(), cy = static_cast<double>(c.y()) - a.y();
+    double b2 = bx * bx + by * by;
+    double c2 = cx * cx + cy * cy;
+    double d = 2 * (bx * cy - by * cx);
+    return Point<double>((cy * b2 - by * c2) / d, (bx * c2 - cx * b2) / d);
+}
+
+} // namespace detail
+
+// center of the circle through `a`, `b`, `c`, not finite for collinear points
+template<typename Tp>
+Point<double> Circumcenter(const Point<Tp, 2>& a, const Point<Tp, 2>& b, const Point<Tp, 2>& c) {
+    Point<double> offset = detail::CircumcenterOffset(a, b, c);
+    return Point<double>(a.x() + offset.x(), a.y() + offset.y());
+}
+
+// radius of the same circle, infinite for collinear points
+template<typename Tp>
+double Circumradius(const Point<Tp, 2>& a, const Point<Tp, 2>& b, const Point<Tp, 2>& c) {
+    Point<double> offset = detail::CircumcenterOffset(a, b, c);
+    double radius = std::hypot(offset.x(), offset.y());
+    return std::isnan(radius) ? std::numeric_limits<double>::infinity() : radius;
+}
+
 template<typename Tp> 
 class Circle {
 private:
@@ -3,12 +3,86 @@
 #include <list>
 #include <cassert>
 #include <iostream>
+#include <vector>
+#include <memory>
+#include <cstddef>
 
 namespace geometry {
 
-const int MAX_MEM = 1e8;
-int mpos = 0;
-char mem[MAX_MEM];
+// bump allocator of list nodes
+// nodes aren't freed one by one, memory is reused after `Release` of an earlier mark
+class Arena {
+public:
+    struct Mark {
+        size_t block;
+        size_t pos;
+    };
+
+public:
+    Arena()
+        : block_(0)
+        , pos_(0)
+    {}
+
+    void* Allocate(size_t n) {
+        const size_t align = alignof(std::max_align_t);
+        n = (n + align - 1) / align * align;
+        assert(n <= BLOCK_SIZE);
+
+        if (blocks_.empty() || pos_ + n > BLOCK_SIZE) {
+            if (!blocks_.empty())
+                ++block_;
+            if (block_ == blocks_.size())
+                blocks_.push_back(std::unique_ptr<char[]>(new char[BLOCK_SIZE]));
+            pos_ = 0;
+        }
+
+        void* res = blocks_[block_].get() + pos_;
+        pos_ += n;
+        return res;
+    }
+
+    Mark GetMark() const {
+        return Mark{block_, pos_};
+    }
+
+    void Release(const Mark& mark) {
+        block_ = mark.block;
+        pos_ = mark.pos;
+    }
+
+private:
+    static const size_t BLOCK_SIZE = 1 << 20;
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    size_t block_;
+    size_t pos_;
+};
+
+// every thread allocates nodes from its own arena
+inline Arena& LocalArena() {
+    static thread_local Arena arena;
+    return arena;
+}
+
+// releases memory allocated in the current thread during the lifetime of the scope
+// must be created before the lists it outlives
+class ArenaScope {
+public:
+    ArenaScope()
+        : mark_(LocalArena().GetMark())
+    {}
+
+    ~ArenaScope() {
+        LocalArena().Release(mark_);
+    }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    Arena::Mark mark_;
+};
 
 template <typename T>
 struct Node {
@@ -23,10 +97,7 @@ struct Node {
     {}
 
     void * operator new ( size_t n ) {
-      char *res = mem + mpos;
-      mpos += n;
-      assert(mpos <= MAX_MEM);
-      return (void *)res;
+      return LocalArena().Allocate(n);
     }
 
     void operator delete (void *) noexcept { }
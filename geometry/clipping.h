@@ -0,0 +1,491 @@
+#ifndef CLIPPING_H
+#define CLIPPING_H
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+#include "point.h"
+#include "vector.h"
+#include "polygon.h"
+#include "segment.h"
+#include "predicates.h"
+#include "snap_rounding.h"
+#include "parallel.h"
+
+namespace geometry {
+
+enum BooleanType : int {
+    INTERSECTION, UNION, DIFFERENCE, XOR
+};
+
+// returns intersection of convex polygons `p` and `q` given in counterclockwise order
+// edges of the polygons chase each other like in `GetConvexDiameter`, O(n + m)
+// (O'Rourke, Chien, Olson, Naddor); the result is empty if interiors don't intersect
+template<typename Tp>
+Polygon<double> ConvexIntersection(const Polygon<Tp>& p, const Polygon<Tp>& q) {
+    typedef Point<double> DPnt;
+    typedef typename PredicateType<Tp>::type T;
+    enum { UNKNOWN, P_IN, Q_IN } inflag = UNKNOWN;
+
+    size_t n = p.Size();
+    size_t m = q.Size();
+    assert(n >= 3 && m >= 3);
+
+    std::vector<DPnt> res;
+    auto add = [&res] (const DPnt& x) {
+        if (res.empty() || !(res.back() == x))
+            res.push_back(x);
+    };
+
+    // returns: 0 - no intersection, 1 - proper or at endpoint (`x` is set), 2 - collinear overlap
+    auto intersect = [] (const Point<Tp>& a, const Point<Tp>& b,
+                         const Point<Tp>& c, const Point<Tp>& d, DPnt& x) -> int {
+        T denom = ((T) b.x() - a.x()) * ((T) d.y() - c.y()) - ((T) b.y() - a.y()) * ((T) d.x() - c.x());
+        if (denom == 0) {
+            if (Orientation(a, b, c) != 0)
+                return 0;
+            // collinear segments overlap if their lexicographic ranges do
+            const Point<Tp>& lo = std::max(std::min(a, b), std::min(c, d));
+            const Point<Tp>& hi = std::min(std::max(a, b), std::max(c, d));
+            return hi < lo ? 0 : 2;
+        }
+
+        T s = ((T) c.x() - a.x()) * ((T) d.y() - c.y()) - ((T) c.y() - a.y()) * ((T) d.x() - c.x());
+        T t = ((T) c.x() - a.x()) * ((T) b.y() - a.y()) - ((T) c.y() - a.y()) * ((T) b.x() - a.x());
+        if (denom < 0) {
+            denom = -denom;
+            s = -s;
+            t = -t;
+        }
+        if (s < 0 || s > denom || t < 0 || t > denom)
+            return 0;
+
+        double k = static_cast<double>(s) / static_cast<double>(denom);
+        x = DPnt(a.x() + k * ((double) b.x() - a.x()), a.y() + k * ((double) b.y() - a.y()));
+        return 1;
+    };
+
+    size_t a = 0, b = 0, aa = 0, ba = 0;
+    bool first_point = true;
+    do {
+        size_t a1 = (a + n - 1) % n;
+        size_t b1 = (b + m - 1) % m;
+        Vector<Tp> av(p[a1], p[a]);
+        Vector<Tp> bv(q[b1], q[b]);
+
+        int cross = Sign(av.template Cross<T>(bv));
+        int a_hb = Orientation(q[b1], q[b], p[a]);
+        int b_ha = Orientation(p[a1], p[a], q[b]);
+
+        DPnt x;
+        int code = intersect(p[a1], p[a], q[b1], q[b], x);
+        if (code == 1) {
+            if (inflag == UNKNOWN && first_point) {
+                aa = ba = 0;
+                first_point = false;
+            }
+            add(x);
+            if (a_hb > 0)
+                inflag = P_IN;
+            else if (b_ha > 0)
+                inflag = Q_IN;
+        }
+
+        // edges overlap and are oppositely oriented, or are parallel and separated
+        if (code == 2 && av.template DotProduct<T>(bv) < 0)
+            return Polygon<double>();
+        if (cross == 0 && a_hb < 0 && b_ha < 0)
+            return Polygon<double>();
+
+        bool advance_a;
+        if (cross == 0 && a_hb == 0 && b_ha == 0)
+            advance_a = inflag != P_IN;
+        else if (cross >= 0)
+            advance_a = b_ha > 0;
+        else
+            advance_a = a_hb <= 0;
+
+        if (advance_a) {
+            if (inflag == P_IN)
+                add(p[a]);
+            ++aa;
+            a = (a + 1) % n;
+        } else {
+            if (inflag == Q_IN)
+                add(q[b]);
+            ++ba;
+            b = (b + 1) % m;
+        }
+    } while ((aa < n || ba < m) && aa < 2 * n && ba < 2 * m);
+
+    if (inflag == UNKNOWN) {
+        // boundaries don't cross: one polygon is inside the other or they are disjoint
+        res.clear();
+        if (q.CheckConvexInside(p[0]) != OUTSIDE && q.CheckConvexInside(p[1]) != OUTSIDE) {
+            for (size_t i = 0; i < n; ++i)
+                res.push_back(p[i]);
+        } else if (p.CheckConvexInside(q[0]) != OUTSIDE && p.CheckConvexInside(q[1]) != OUTSIDE) {
+            for (size_t i = 0; i < m; ++i)
+                res.push_back(q[i]);
+        }
+    }
+
+    while (res.size() > 1 && res.back() == res[0])
+        res.pop_back();
+    if (res.size() < 3)
+        return Polygon<double>();
+
+    return Polygon<double>(std::move(res));
+}
+
+// boolean operations over sets of rings with the even-odd fill rule
+//
+// edges of both operands are snap rounded (see `SnapRounding`) to the `SnapGrid::Dyadic`
+// grid of the input: the rounded edges only meet at vertices or coincide, so the arrangement
+// is exact in integers, no edge is ever cut at a rounded point; coincident pieces are merged
+// by the parity of every operand
+// the sweep over the pieces computes the inside flags of the both operands below every
+// piece (Martinez-Rueda), the pieces separating result from non-result are chained into
+// rings with the result on the left: outer rings are counterclockwise, holes are clockwise
+//
+// output vertices are input vertices or centers of the pixels of intersections, the pixel
+// is about 2^-30 of the extent of the input; coordinates lying on the grid, like integers
+// of the input with the extent below 2^30, are exact; rings are split at repeated vertices
+// and rings degenerated to segments are dropped
+template<typename Tp>
+class Clipper {
+private:
+    typedef IntPoint Pnt;
+
+    // `a` < `b`, `has` - bit mask of operands having the edge (1 - subject, 2 - clip)
+    struct Edge {
+        Edge() {}
+
+        Edge(const Pnt& a, const Pnt& b, int has)
+            : a(a)
+            , b(b)
+            , has(has)
+        {}
+
+        bool operator<(const Edge& oth) const {
+            return a < oth.a || (a == oth.a && (b < oth.b || (b == oth.b && has < oth.has)));
+        }
+
+        Pnt a, b;
+        int has;
+    };
+
+    struct Event {
+        Event(const Pnt& p, bool left, size_t id)
+            : p(p)
+            , left(left)
+            , id(id)
+        {}
+
+        Pnt p;
+        bool left;
+        size_t id;
+    };
+
+    // order of the sweep status: `i` lies below `j` at the current sweep position
+    struct Below {
+        explicit Below(const std::vector<Edge>& edges)
+            : edges(&edges)
+        {}
+
+        bool operator()(size_t i, size_t j) const {
+            if (i == j)
+                return false;
+
+            const Edge& s = (*edges)[i];
+            const Edge& t = (*edges)[j];
+            int side = SweepOrder(s.a, s.b, t.a, t.b);
+            return side < 0 || (side == 0 && i < j);
+        }
+
+        const std::vector<Edge>* edges;
+    };
+
+    typedef std::set<size_t, Below> Status;
+
+public:
+    std::vector<Polygon<double>> Run(const std::vector<Polygon<Tp>>& subject,
+                                     const std::vector<Polygon<Tp>>& clip, BooleanType op)
+    {
+        points_.clear();
+        segments_.clear();
+        operands_.clear();
+        AddRings(subject, 1);
+        AddRings(clip, 2);
+
+        Split();
+        ComputeInside();
+        return Chain(op);
+    }
+
+private:
+    void AddRings(const std::vector<Polygon<Tp>>& rings, int operand) {
+        for (const auto& ring: rings) {
+            size_t first = points_.size();
+            for (size_t i = 0; i < ring.Size(); ++i) {
+                points_.push_back(ring[i]);
+                segments_.push_back(std::make_pair(first + i, first + (i + 1) % ring.Size()));
+                operands_.push_back(operand);
+            }
+        }
+    }
+
+    // splits edges into the pieces of the snap rounded arrangement, merges coincident
+    // pieces by the parity of every operand
+    void Split() {
+        grid_ = SnapGrid::Dyadic(points_);
+        SnapRounding<Tp> snap(grid_);
+        snap.Build(points_, segments_);
+
+        const std::vector<IntPoint>& vertices = snap.Vertices();
+        const std::vector<size_t>& offsets = snap.Offsets();
+        const std::vector<size_t>& chains = snap.Chains();
+        edges_.clear();
+        for (size_t k = 0; k < segments_.size(); ++k) {
+            for (size_t i = offsets[k]; i + 1 < offsets[k + 1]; ++i) {
+                Pnt a = vertices[chains[i]];
+                Pnt b = vertices[chains[i + 1]];
+                if (b < a)
+                    std::swap(a, b);
+                edges_.push_back(Edge(a, b, operands_[k]));
+            }
+        }
+
+        std::sort(edges_.begin(), edges_.end());
+        std::vector<Edge> merged;
+        for (size_t i = 0; i < edges_.size();) {
+            size_t j = i;
+            int has = 0;
+            while (j < edges_.size() && edges_[j].a == edges_[i].a && edges_[j].b == edges_[i].b)
+                has ^= edges_[j++].has;
+            if (has != 0)
+                merged.push_back(Edge(edges_[i].a, edges_[i].b, has));
+            i = j;
+        }
+        edges_.swap(merged);
+    }
+
+    // below_[i] - bit mask of operands containing the region just below edge `i`
+    void ComputeInside() {
+        std::vector<Event> events;
+        events.reserve(2 * edges_.size());
+        for (size_t i = 0; i < edges_.size(); ++i) {
+            events.push_back(Event(edges_[i].a, true, i));
+            events.push_back(Event(edges_[i].b, false, i));
+        }
+        // at the same point right ends go first, then left ends from bottom to top
+        Below below(edges_);
+        std::sort(events.begin(), events.end(), [&below] (const Event& e, const Event& f) {
+            if (!(e.p == f.p))
+                return e.p < f.p;
+            if (e.left != f.left)
+                return f.left;
+            return e.left && below(e.id, f.id);
+        });
+
+        Status status(below);
+        std::vector<typename Status::iterator> where(edges_.size());
+        below_.assign(edges_.size(), 0);
+
+        for (const Event& e: events) {
+            if (!e.left) {
+                status.erase(where[e.id]);
+                continue;
+            }
+
+            auto it = status.insert(e.id).first;
+            where[e.id] = it;
+            if (it != status.begin()) {
+                size_t prev = *std::prev(it);
+                below_[e.id] = below_[prev] ^ edges_[prev].has;
+            }
+        }
+    }
+
+    static bool Inside(int mask, BooleanType op) {
+        bool a = (mask & 1) != 0;
+        bool b = (mask & 2) != 0;
+        switch (op) {
+            case INTERSECTION: return a && b;
+            case UNION: return a || b;
+            case DIFFERENCE: return a && !b;
+            default: return a != b;
+        }
+    }
+
+    // counterclockwise order of directions `u` and `v` from the angle just above 0, exact
+    static bool AngleLess(const Pnt& u, const Pnt& v) {
+        bool upper_u = u.y() > 0 || (u.y() == 0 && u.x() > 0);
+        bool upper_v = v.y() > 0 || (v.y() == 0 && v.x() > 0);
+        if (upper_u != upper_v)
+            return upper_u;
+        return Vector<long long>(u).Cross(Vector<long long>(v)) > 0;
+    }
+
+    // at every vertex the ring continues with the first edge clockwise from the reversed
+    // incoming one, so rings touching at a vertex stay separate
+    std::vector<Polygon<double>> Chain(BooleanType op) {
+        const size_t NONE = static_cast<size_t>(-1);
+        typedef std::pair<size_t, Pnt> Out;
+
+        std::vector<std::pair<Pnt, Pnt>> directed;
+        for (size_t i = 0; i < edges_.size(); ++i) {
+            bool below = Inside(below_[i], op);
+            bool above = Inside(below_[i] ^ edges_[i].has, op);
+            if (below == above)
+                continue;
+            if (above)
+                directed.push_back(std::make_pair(edges_[i].a, edges_[i].b));
+            else
+                directed.push_back(std::make_pair(edges_[i].b, edges_[i].a));
+        }
+
+        std::vector<Pnt> vertices;
+        for (const auto& e: directed)
+            vertices.push_back(e.first);
+        std::sort(vertices.begin(), vertices.end());
+        vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+        auto id = [&vertices] (const Pnt& p) {
+            return static_cast<size_t>(std::lower_bound(vertices.begin(), vertices.end(), p) - vertices.begin());
+        };
+
+        // outgoing edges of every vertex ordered counterclockwise by angle
+        std::vector<Out> out(directed.size());
+        std::vector<size_t> offsets(vertices.size() + 1, 0);
+        for (const auto& e: directed)
+            ++offsets[id(e.first) + 1];
+        for (size_t v = 0; v < vertices.size(); ++v)
+            offsets[v + 1] += offsets[v];
+        std::vector<size_t> pos(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < directed.size(); ++i) {
+            const Pnt& a = directed[i].first;
+            out[pos[id(a)]++] = Out(i, directed[i].second - a);
+        }
+        auto less = [] (const Out& x, const Out& y) {
+            return AngleLess(x.second, y.second);
+        };
+        for (size_t v = 0; v < vertices.size(); ++v)
+            std::sort(out.begin() + offsets[v], out.begin() + offsets[v + 1], less);
+
+        auto next = [&] (size_t i) -> size_t {
+            const Pnt& a = directed[i].first;
+            const Pnt& b = directed[i].second;
+            size_t v = id(b);
+            if (v == vertices.size() || !(vertices[v] == b) || offsets[v] == offsets[v + 1])
+                return NONE;
+
+            size_t begin = offsets[v], end = offsets[v + 1];
+            size_t k = std::lower_bound(out.begin() + begin, out.begin() + end,
+                                        Out(0, a - b), less) - out.begin();
+            return out[k == begin ? end - 1 : k - 1].first;
+        };
+
+        std::vector<Polygon<double>> res;
+        std::vector<bool> used(directed.size(), false);
+        // position of a vertex in the open part of the ring
+        std::vector<size_t> at(vertices.size(), NONE);
+        for (size_t start = 0; start < directed.size(); ++start) {
+            if (used[start])
+                continue;
+
+            std::vector<Pnt> ring;
+            size_t i = start;
+            while (i != NONE && !used[i]) {
+                used[i] = true;
+                ring.push_back(directed[i].first);
+                i = next(i);
+            }
+            if (i != start)
+                continue;
+
+            // a ring passing a vertex twice is split there into rings without repeated vertices
+            std::vector<Pnt> open;
+            for (const Pnt& p: ring) {
+                size_t v = id(p);
+                if (at[v] == NONE) {
+                    at[v] = open.size();
+                    open.push_back(p);
+                    continue;
+                }
+                std::vector<Pnt> loop(open.begin() + at[v], open.end());
+                for (size_t k = at[v] + 1; k < open.size(); ++k)
+                    at[id(open[k])] = NONE;
+                open.resize(at[v] + 1);
+                AddRing(loop, res);
+            }
+            for (const Pnt& p: open)
+                at[id(p)] = NONE;
+            AddRing(open, res);
+        }
+
+        return res;
+    }
+
+    // appends the ring unless it degenerates to a segment
+    void AddRing(std::vector<Pnt>& ring, std::vector<Polygon<double>>& res) const {
+        RemoveCollinear(ring);
+        if (ring.size() < 3)
+            return;
+
+        std::vector<Point<double>> unsnapped;
+        unsnapped.reserve(ring.size());
+        for (const Pnt& p: ring)
+            unsnapped.push_back(grid_.Unsnap(p));
+        res.push_back(Polygon<double>(std::move(unsnapped)));
+    }
+
+    static void RemoveCollinear(std::vector<Pnt>& ring) {
+        std::vector<Pnt> res;
+        for (size_t i = 0; i < ring.size(); ++i) {
+            const Pnt& prev = res.empty() ? ring.back() : res.back();
+            const Pnt& next = ring[(i + 1) % ring.size()];
+            if (Orientation(prev, ring[i], next) != 0)
+                res.push_back(ring[i]);
+        }
+        ring.swap(res);
+    }
+
+private:
+    std::vector<Point<Tp>> points_;
+    std::vector<std::pair<size_t, size_t>> segments_;
+    std::vector<int> operands_;
+
+    SnapGrid grid_;
+    std::vector<Edge> edges_;
+    std::vector<int> below_;
+};
+
+// returns rings of `op` applied to `subject` and `clip`, see `Clipper`
+template<typename Tp>
+std::vector<Polygon<double>> Boolean(const std::vector<Polygon<Tp>>& subject,
+                                     const std::vector<Polygon<Tp>>& clip, BooleanType op)
+{
+    return Clipper<Tp>().Run(subject, clip, op);
+}
+
+// batch version of `Boolean`, res[i] is `op` applied to subjects[i] and clips[i]
+// operations are independent, so tiles of a large overlay are processed in parallel
+template<typename Tp>
+std::vector<std::vector<Polygon<double>>> Boolean(const std::vector<std::vector<Polygon<Tp>>>& subjects,
+                                                  const std::vector<std::vector<Polygon<Tp>>>& clips,
+                                                  BooleanType op, size_t threads)
+{
+    assert(subjects.size() == clips.size());
+    std::vector<std::vector<Polygon<double>>> res(subjects.size());
+    ParallelChunks(subjects.size(), threads, [&] (size_t, size_t begin, size_t end) {
+        Clipper<Tp> clipper;
+        for (size_t i = begin; i < end; ++i)
+            res[i] = clipper.Run(subjects[i], clips[i], op);
+    });
+    return res;
+}
+
+} // namespace geometry
+
+#endif // CLIPPING_H
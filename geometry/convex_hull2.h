@@ -0,0 +1,271 @@
+#ifndef CONVEX_HULL2_H
+#define CONVEX_HULL2_H
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <limits>
+#include <cmath>
+#include <cassert>
+#include "point.h"
+#include "vector.h"
+#include "predicates.h"
+#include "parallel.h"
+
+namespace geometry {
+
+// 2D convex hull by QuickHull
+//
+// the lowest and the highest points split the rest into the lower and the upper sets,
+// every set lying right of its edge (a, b) is split by its farthest point f into the points
+// right of (a, f) and right of (f, b), points inside triangle (a, f, b) are dropped,
+// so interior points go away in the first rounds
+// side tests compute cross products in double, `Orientation` is evaluated only if the result
+// is within the rounding error (Shewchuk's filter); it's exact for floating point coordinates
+// and for integer ones in the range of `PredicateType`, coordinates must convert to double
+// exactly
+//
+// points are moved between two buffers: a set is split into the front and the back
+// of its range in the other buffer, large sets are split by threads with counts per chunk,
+// and the halves are solved in their own threads until threads run out
+// the result is the same as `Polygon::ConvexHull`: counterclockwise order from the lowest
+// left point, points on hull edges aren't vertices
+template<typename Tp>
+class ConvexHull2 {
+private:
+    typedef Point<Tp> Pnt;
+    typedef typename PredicateType<Tp>::type T;
+
+public:
+    ConvexHull2() {}
+
+    explicit ConvexHull2(const std::vector<Pnt>& points, size_t threads = 1) {
+        Build(points.data(), points.size(), threads);
+    }
+
+    void Build(const Pnt* points, size_t count, size_t threads = 1) {
+        hull_.clear();
+        if (count == 0)
+            return;
+
+        size_t chunks = ThreadsCount(threads, count / GRAIN);
+        std::vector<std::pair<Pnt, Pnt>> bounds(chunks);
+        ParallelChunks(count, chunks, [&] (size_t chunk, size_t begin, size_t end) {
+            auto minmax = std::minmax_element(points + begin, points + end);
+            bounds[chunk] = std::make_pair(*minmax.first, *minmax.second);
+        });
+
+        Pnt lo = bounds[0].first;
+        Pnt hi = bounds[0].second;
+        for (const auto& bound: bounds) {
+            lo = std::min(lo, bound.first);
+            hi = std::max(hi, bound.second);
+        }
+
+        hull_.push_back(lo);
+        if (lo == hi)
+            return;
+
+        first_.resize(count);
+        second_.resize(count);
+        Parts parts = Split(points, first_.data(), 0, count, lo, hi, lo, threads);
+
+        std::vector<Pnt> upper;
+        size_t lower_threads = std::max<size_t>(threads / 2, 1);
+        std::thread worker;
+        if (threads > 1) {
+            worker = std::thread([&] {
+                Hull(first_.data(), second_.data(), parts.second, count, hi, lo,
+                     parts.far2, threads - lower_threads, upper);
+            });
+        }
+
+        Hull(first_.data(), second_.data(), 0, parts.first, lo, hi, parts.far1, lower_threads, hull_);
+        hull_.push_back(hi);
+
+        if (threads > 1)
+            worker.join();
+        else
+            Hull(first_.data(), second_.data(), parts.second, count, hi, lo, parts.far2, 1, upper);
+        hull_.insert(hull_.end(), upper.begin(), upper.end());
+
+        std::vector<Pnt>().swap(first_);
+        std::vector<Pnt>().swap(second_);
+    }
+
+    // vertices in counterclockwise order starting from the lowest left point
+    const std::vector<Pnt>& Points() const {
+        return hull_;
+    }
+
+private:
+    // sets smaller than this are split by one thread
+    static const size_t GRAIN = 1 << 15;
+
+    // [begin, first) are right of (a, f), [second, end) are right of (f, b)
+    struct Parts {
+        size_t first;
+        size_t second;
+        Pnt far1;
+        Pnt far2;
+    };
+
+    struct Farthest {
+        double dist;
+        Pnt p;
+    };
+
+    // positive if `p` is strictly right of line (a, b), its distance times |ab| otherwise
+    // the sign is decided by `Orientation` when the filter can't, the value is then tiny
+    static double Right(const Pnt& a, const Pnt& b, const Pnt& p) {
+        double bax = static_cast<double>(b.x()) - a.x();
+        double bay = static_cast<double>(b.y()) - a.y();
+        double pax = static_cast<double>(p.x()) - a.x();
+        double pay = static_cast<double>(p.y()) - a.y();
+
+        double left = bay * pax;
+        double right = bax * pay;
+        double det = left - right;
+        double bound = 3.3306690738754716e-16 * (std::abs(left) + std::abs(right));
+        if (det > bound || -det > bound)
+            return det;
+        return -Orientation(a, b, p) * std::numeric_limits<double>::min();
+    }
+
+    // keeps the point farther from line (a, b), close distances are compared by the cross
+    // product, exactly for integer coordinates;
+    // of equally far points the last one along (a, b) is kept, so `f` is never
+    // in the middle of a hull edge
+    static void Update(Farthest& best, double dist, const Pnt& p, const Pnt& a, const Pnt& b) {
+        double bound = 1e-12 * std::max(dist, best.dist);
+        if (dist > best.dist + bound) {
+            best = Farthest{dist, p};
+        } else if (dist >= best.dist - bound) {
+            Vector<Tp> ab(a, b);
+            Vector<Tp> diff(best.p, p);
+            T cross = ab.template Cross<T>(diff);
+            if (cross < 0 || (cross == 0 && ab.template DotProduct<T>(diff) > 0))
+                best = Farthest{dist, p};
+        }
+    }
+
+    // splits src[begin, end) into dst, see `Parts`, the rest is dropped
+    Parts Split(const Pnt* src, Pnt* dst, size_t begin, size_t end,
+                const Pnt& a, const Pnt& f, const Pnt& b, size_t threads) {
+        size_t count = end - begin;
+        size_t chunks = ThreadsCount(threads, count / GRAIN);
+        std::vector<size_t> firsts(chunks + 1, 0);
+        std::vector<size_t> seconds(chunks + 1, 0);
+
+        if (chunks > 1) {
+            ParallelChunks(count, chunks, [&] (size_t chunk, size_t from, size_t to) {
+                for (size_t i = begin + from; i < begin + to; ++i) {
+                    if (Right(a, f, src[i]) > 0)
+                        ++firsts[chunk + 1];
+                    else if (Right(f, b, src[i]) > 0)
+                        ++seconds[chunk + 1];
+                }
+            });
+            for (size_t chunk = 0; chunk < chunks; ++chunk) {
+                firsts[chunk + 1] += firsts[chunk];
+                seconds[chunk + 1] += seconds[chunk];
+            }
+        }
+
+        std::vector<Farthest> far1(chunks, Farthest{0, a});
+        std::vector<Farthest> far2(chunks, Farthest{0, b});
+        ParallelChunks(count, chunks, [&] (size_t chunk, size_t from, size_t to) {
+            size_t first = begin + firsts[chunk];
+            size_t second = end - seconds[chunk];
+            for (size_t i = begin + from; i < begin + to; ++i) {
+                double dist = Right(a, f, src[i]);
+                if (dist > 0) {
+                    Update(far1[chunk], dist, src[i], a, f);
+                    dst[first++] = src[i];
+                    continue;
+                }
+
+                dist = Right(f, b, src[i]);
+                if (dist > 0) {
+                    Update(far2[chunk], dist, src[i], f, b);
+                    dst[--second] = src[i];
+                }
+            }
+            firsts[chunk] = first;
+            seconds[chunk] = second;
+        });
+
+        for (size_t chunk = 1; chunk < chunks; ++chunk) {
+            Update(far1[0], far1[chunk].dist, far1[chunk].p, a, f);
+            Update(far2[0], far2[chunk].dist, far2[chunk].p, f, b);
+        }
+        return Parts{firsts[chunks - 1], seconds[chunks - 1], far1[0].p, far2[0].p};
+    }
+
+    // appends vertices between `a` and `b` of the hull of src[begin, end),
+    // which lie right of (a, b), `f` is the farthest of them
+    void Hull(Pnt* src, Pnt* dst, size_t begin, size_t end, const Pnt& a, const Pnt& b,
+              const Pnt& f, size_t threads, std::vector<Pnt>& res) {
+        if (begin == end)
+            return;
+
+        if (threads > 1 && end - begin > GRAIN) {
+            Parts parts = Split(src, dst, begin, end, a, f, b, threads);
+
+            std::vector<Pnt> left;
+            size_t left_threads = threads / 2;
+            std::thread worker([&] {
+                Hull(dst, src, begin, parts.first, a, f, parts.far1, left_threads, left);
+            });
+            std::vector<Pnt> right;
+            Hull(dst, src, parts.second, end, f, b, parts.far2, threads - left_threads, right);
+            worker.join();
+
+            res.insert(res.end(), left.begin(), left.end());
+            res.push_back(f);
+            res.insert(res.end(), right.begin(), right.end());
+            return;
+        }
+
+        // depth may be linear in the count of vertices, so one thread goes by the stack,
+        // where a task with begin == end is the vertex `f`
+        struct Task {
+            Pnt* src;
+            Pnt* dst;
+            size_t begin;
+            size_t end;
+            Pnt a;
+            Pnt b;
+            Pnt f;
+        };
+
+        std::vector<Task> stack;
+        stack.push_back(Task{src, dst, begin, end, a, b, f});
+        while (!stack.empty()) {
+            Task task = stack.back();
+            stack.pop_back();
+            if (task.begin == task.end) {
+                res.push_back(task.f);
+                continue;
+            }
+
+            Parts parts = Split(task.src, task.dst, task.begin, task.end, task.a, task.f, task.b, 1);
+            if (parts.second < task.end)
+                stack.push_back(Task{task.dst, task.src, parts.second, task.end, task.f, task.b, parts.far2});
+            stack.push_back(Task{nullptr, nullptr, 0, 0, task.f, task.f, task.f});
+            if (task.begin < parts.first)
+                stack.push_back(Task{task.dst, task.src, task.begin, parts.first, task.a, task.f, parts.far1});
+        }
+    }
+
+private:
+    std::vector<Pnt> hull_;
+    std::vector<Pnt> first_;
+    std::vector<Pnt> second_;
+};
+
+template<typename Tp>
+const size_t ConvexHull2<Tp>::GRAIN;
+
+} // namespace geometry
+
+#endif // CONVEX_HULL2_H
@@ -0,0 +1,410 @@
+#ifndef CONVEX_HULL3_H
+#define CONVEX_HULL3_H
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include "point.h"
+#include "vector.h"
+#include "predicates.h"
+#include "triangle_mesh.h"
+#include "parallel.h"
+
+namespace geometry {
+
+// 3D convex hull by QuickHull
+//
+// every face keeps the conflict list of points lying above it; the farthest one is added next,
+// faces it sees are replaced by the cone over the horizon and their points are redistributed
+// plane tests are filtered: the distance to the face plane is computed in double with
+// `CrossProduct` / `DotProduct` and `Orientation` is evaluated only near the plane,
+// it's exact for floating point coordinates and for integer ones up to
+// `MaxOrientation3Coordinate()` by absolute value (1524717566796 with `__int128`,
+// 577053 without it); coordinates must convert to double exactly
+//
+// the result is a closed triangle mesh with counterclockwise faces seen from outside,
+// vertex ids are indices in `points`; points lying on hull faces aren't vertices
+template<typename Tp, typename Index = uint32_t>
+class ConvexHull3 {
+private:
+    typedef Point<Tp, 3> Pnt;
+    typedef TriangleMesh<Index> Mesh;
+
+public:
+    static const Index NONE = Mesh::NONE;
+
+public:
+    ConvexHull3() {}
+
+    // `threads` are used to distribute points among the faces of the first tetrahedron
+    explicit ConvexHull3(const std::vector<Pnt>& points, size_t threads = 1) {
+        Build(points, threads);
+    }
+
+    // degenerate (coplanar) input gives the empty mesh
+    void Build(const std::vector<Pnt>& points, size_t threads = 1) {
+        assert(std::all_of(points.begin(), points.end(), [] (const Pnt& p) {
+            return InRange(p, std::is_integral<Tp>());
+        }));
+        points_ = &points;
+        mesh_.Clear();
+        mesh_.ResizeVertices(points.size());
+        vertices_.clear();
+        twins_.clear();
+        normals_.clear();
+        outside_.clear();
+        marks_.clear();
+        free_.clear();
+        by_origin_.assign(points.size(), NONE);
+        stamp_ = 0;
+
+        coordinates_.resize(points.size());
+        for (size_t i = 0; i < points.size(); ++i)
+            coordinates_[i] = points[i];
+        ComputeErrorBound();
+
+        Index first[4];
+        if (!FindFirstTetrahedron(first))
+            return;
+
+        std::vector<Index> faces(points.size(), NONE);
+        ParallelFor(points.size(), threads, [&] (size_t i) {
+            if (std::find(first, first + 4, i) != first + 4)
+                return;
+
+            for (Index f = 0; f < 4 && faces[i] == NONE; ++f) {
+                if (Above(f, static_cast<Index>(i)))
+                    faces[i] = f;
+            }
+        });
+        for (size_t i = 0; i < points.size(); ++i) {
+            if (faces[i] != NONE)
+                outside_[faces[i]].push_back(static_cast<Index>(i));
+        }
+
+        std::vector<Index> pending;
+        for (Index f = 0; f < 4; ++f)
+            pending.push_back(f);
+
+        while (!pending.empty()) {
+            Index f = pending.back();
+            pending.pop_back();
+            if (IsRemoved(f) || outside_[f].empty())
+                continue;
+
+            AddPoint(f, pending);
+        }
+
+        MakeMesh();
+    }
+
+    const Mesh& GetMesh() const {
+        return mesh_;
+    }
+
+    // returns ids of hull vertices in increasing order
+    std::vector<Index> Vertices() const {
+        std::vector<Index> res;
+        for (size_t v = 0; v < mesh_.VerticesCount(); ++v) {
+            if (mesh_.VertexEdge(v) != NONE)
+                res.push_back(static_cast<Index>(v));
+        }
+        return res;
+    }
+
+private:
+    static Index Next(size_t h) {
+        return Mesh::Next(h);
+    }
+
+    bool IsRemoved(Index f) const {
+        return vertices_[3 * f] == NONE;
+    }
+
+    // bounds the rounding error of `Distance`, which is a triple product of coordinate differences
+    // whether `Orientation` is exact for integer coordinates of `p`
+    static bool InRange(const Pnt& p, std::true_type) {
+        long long max_coordinate = MaxOrientation3Coordinate();
+        for (size_t i = 0; i < 3; ++i) {
+            if (p.Get(i) > max_coordinate || p.Get(i) < -max_coordinate)
+                return false;
+        }
+        return true;
+    }
+
+    static bool InRange(const Pnt&, std::false_type) {
+        return true;
+    }
+
+    void ComputeErrorBound() {
+        double span = 0;
+        for (size_t d = 0; d < 3; ++d) {
+            double lo = std::numeric_limits<double>::max();
+            double hi = -lo;
+            for (const auto& p: coordinates_) {
+                lo = std::min(lo, p.Get(d));
+                hi = std::max(hi, p.Get(d));
+            }
+            span = std::max(span, hi - lo);
+        }
+        bound_ = 64 * std::numeric_limits<double>::epsilon() * span * span * span;
+    }
+
+    double Distance(Index f, Index q) const {
+        return normals_[f].DotProduct(Vector<double, 3>(coordinates_[vertices_[3 * f]], coordinates_[q]));
+    }
+
+    // returns true if `q` lies strictly above the plane of face `f`
+    bool Above(Index f, Index q) const {
+        double dist = Distance(f, q);
+        if (std::abs(dist) > bound_)
+            return dist > 0;
+
+        const std::vector<Pnt>& points = *points_;
+        return Orientation(points[vertices_[3 * f]], points[vertices_[3 * f + 1]],
+                           points[vertices_[3 * f + 2]], points[q]) > 0;
+    }
+
+    Index NewFace(Index a, Index b, Index c) {
+        Index f;
+        if (!free_.empty()) {
+            f = free_.back();
+            free_.pop_back();
+        } else {
+            f = static_cast<Index>(normals_.size());
+            vertices_.resize(vertices_.size() + 3);
+            twins_.resize(twins_.size() + 3, NONE);
+            normals_.resize(normals_.size() + 1);
+            outside_.resize(outside_.size() + 1);
+            marks_.push_back(0);
+        }
+
+        vertices_[3 * f] = a;
+        vertices_[3 * f + 1] = b;
+        vertices_[3 * f + 2] = c;
+        normals_[f] = Vector<double, 3>(coordinates_[a], coordinates_[b])
+            .CrossProduct(Vector<double, 3>(coordinates_[a], coordinates_[c]));
+        marks_[f] = 0;
+        return f;
+    }
+
+    void SetTwin(Index h, Index g) {
+        twins_[h] = g;
+        twins_[g] = h;
+    }
+
+    // extreme points make the first tetrahedron large, so most points are dropped at once
+    bool FindFirstTetrahedron(Index (&first)[4]) {
+        const std::vector<Pnt>& points = *points_;
+        if (points.empty())
+            return false;
+
+        Index a = 0, b = 0;
+        for (Index i = 0; i < points.size(); ++i) {
+            if (points[i] < points[a])
+                a = i;
+            if (points[b] < points[i])
+                b = i;
+        }
+        if (points[a] == points[b])
+            return false;
+
+        Index c = NONE;
+        double best = 0;
+        Vector<double, 3> ab(coordinates_[a], coordinates_[b]);
+        for (Index i = 0; i < points.size(); ++i) {
+            double dist = ab.CrossProduct(Vector<double, 3>(coordinates_[a], coordinates_[i])).Length2();
+            if ((c == NONE || dist > best) && !Collinear(points[a], points[b], points[i])) {
+                c = i;
+                best = dist;
+            }
+        }
+        if (c == NONE)
+            return false;
+
+        Index d = NONE;
+        best = 0;
+        Vector<double, 3> normal = ab.CrossProduct(Vector<double, 3>(coordinates_[a], coordinates_[c]));
+        for (Index i = 0; i < points.size(); ++i) {
+            double dist = std::abs(normal.DotProduct(Vector<double, 3>(coordinates_[a], coordinates_[i])));
+            if ((d == NONE || dist > best) && Orientation(points[a], points[b], points[c], points[i]) != 0) {
+                d = i;
+                best = dist;
+            }
+        }
+        if (d == NONE)
+            return false;
+
+        if (Orientation(points[a], points[b], points[c], points[d]) < 0)
+            std::swap(a, b);
+
+        // `d` is above `a`, `b`, `c`, so faces are oriented away from the opposite vertex
+        NewFace(a, c, b);
+        NewFace(a, b, d);
+        NewFace(b, c, d);
+        NewFace(c, a, d);
+        for (size_t h = 0; h < 12; ++h) {
+            for (size_t g = 0; g < 12; ++g) {
+                if (vertices_[h] == vertices_[Next(g)] && vertices_[Next(h)] == vertices_[g])
+                    twins_[h] = static_cast<Index>(g);
+            }
+        }
+
+        first[0] = a;
+        first[1] = b;
+        first[2] = c;
+        first[3] = d;
+        return true;
+    }
+
+    // adds the farthest point above face `f`, new faces with points are pushed to `pending`
+    void AddPoint(Index f, std::vector<Index>& pending) {
+        std::vector<Index>& candidates = outside_[f];
+        size_t far = 0;
+        double best = Distance(f, candidates[0]);
+        for (size_t i = 1; i < candidates.size(); ++i) {
+            double dist = Distance(f, candidates[i]);
+            if (dist > best) {
+                best = dist;
+                far = i;
+            }
+        }
+        Index p = candidates[far];
+        std::swap(candidates[far], candidates.back());
+        candidates.pop_back();
+
+        // faces visible from `p` by breadth first search, marks: stamp_ - visible, stamp_ + 1 - not
+        stamp_ += 2;
+        visible_.assign(1, f);
+        marks_[f] = stamp_;
+        for (size_t i = 0; i < visible_.size(); ++i) {
+            Index g = visible_[i];
+            for (size_t k = 0; k < 3; ++k) {
+                Index n = twins_[3 * g + k] / 3;
+                if (marks_[n] == stamp_ || marks_[n] == stamp_ + 1)
+                    continue;
+
+                marks_[n] = Above(n, p) ? stamp_ : stamp_ + 1;
+                if (marks_[n] == stamp_)
+                    visible_.push_back(n);
+            }
+        }
+
+        // horizon: edges of visible faces, which twins aren't visible
+        horizon_.clear();
+        orphans_.clear();
+        for (Index g: visible_) {
+            for (size_t k = 0; k < 3; ++k) {
+                Index twin = twins_[3 * g + k];
+                if (marks_[twin / 3] != stamp_)
+                    horizon_.push_back(twin);
+            }
+            orphans_.insert(orphans_.end(), outside_[g].begin(), outside_[g].end());
+            outside_[g].clear();
+            vertices_[3 * g] = NONE;
+            free_.push_back(g);
+        }
+
+        // cone over the horizon: face (a, b, p) for the horizon edge b -> a
+        // faces are linked through the face starting at every horizon vertex
+        created_.clear();
+        for (Index twin: horizon_) {
+            Index a = vertices_[Next(twin)];
+            Index b = vertices_[twin];
+            Index g = NewFace(a, b, p);
+            SetTwin(3 * g, twin);
+            created_.push_back(g);
+            by_origin_[a] = g;
+        }
+        for (Index g: created_) {
+            Index next = by_origin_[vertices_[3 * g + 1]];
+            SetTwin(3 * g + 1, 3 * next + 2);
+        }
+
+        // a point outside of the new hull sees either a new face or a face beyond the horizon,
+        // since faces it sees are connected and include a visible one
+        for (Index q: orphans_) {
+            Index face = NONE;
+            for (size_t i = 0; i < created_.size() && face == NONE; ++i) {
+                if (Above(created_[i], q))
+                    face = created_[i];
+            }
+            for (size_t i = 0; i < horizon_.size() && face == NONE; ++i) {
+                if (Above(horizon_[i] / 3, q))
+                    face = horizon_[i] / 3;
+            }
+            if (face != NONE)
+                outside_[face].push_back(q);
+        }
+
+        for (Index g: created_) {
+            if (!outside_[g].empty())
+                pending.push_back(g);
+        }
+        for (Index twin: horizon_) {
+            if (!outside_[twin / 3].empty())
+                pending.push_back(twin / 3);
+        }
+    }
+
+    void MakeMesh() {
+        std::vector<Index> remap(normals_.size(), NONE);
+        Index count = 0;
+        for (Index f = 0; f < normals_.size(); ++f) {
+            if (!IsRemoved(f))
+                remap[f] = count++;
+        }
+
+        mesh_.Reserve(count);
+        for (Index f = 0; f < normals_.size(); ++f) {
+            if (!IsRemoved(f))
+                mesh_.AddTriangle(vertices_[3 * f], vertices_[3 * f + 1], vertices_[3 * f + 2]);
+        }
+        for (Index f = 0; f < normals_.size(); ++f) {
+            if (IsRemoved(f))
+                continue;
+            for (size_t k = 0; k < 3; ++k) {
+                Index twin = twins_[3 * f + k];
+                mesh_.SetTwin(3 * remap[f] + k, 3 * remap[twin / 3] + twin % 3);
+            }
+        }
+    }
+
+private:
+    Mesh mesh_;
+
+    // state of construction
+    const std::vector<Pnt>* points_;
+    std::vector<Point<double, 3>> coordinates_;
+    double bound_;
+    std::vector<Index> vertices_;
+    std::vector<Index> twins_;
+    std::vector<Vector<double, 3>> normals_;
+    std::vector<std::vector<Index>> outside_;
+    std::vector<unsigned> marks_;
+    std::vector<Index> free_;
+    unsigned stamp_;
+
+    // scratch buffers of `AddPoint`
+    std::vector<Index> visible_;
+    std::vector<Index> horizon_;
+    std::vector<Index> orphans_;
+    std::vector<Index> created_;
+    std::vector<Index> by_origin_;
+};
+
+template<typename Tp, typename Index>
+const Index ConvexHull3<Tp, Index>::NONE;
+
+template<typename Tp, typename Index>
+std::ostream& operator << (std::ostream& out, const ConvexHull3<Tp, Index>& hull) {
+    return out << hull.GetMesh();
+}
+
+} // namespace geometry
+
+#endif // CONVEX_HULL3_H
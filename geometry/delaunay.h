@@ -0,0 +1,764 @@
+#ifndef DELAUNAY_H
+#define DELAUNAY_H
+#include <iostream>
+#include <vector>
+#include <cassert>
+#include <algorithm>
+#include <queue>
+#include <cstdint>
+#include "point.h"
+#include "vector.h"
+#include "predicates.h"
+#include "spatial_sort.h"
+#include "triangle_mesh.h"
+#include "parallel.h"
+
+namespace geometry {
+
+// incremental Delaunay triangulation with Lawson flips
+// the result is written directly into `TriangleMesh`, vertex ids are indices of points
+// vertices may be removed, their points stay in `Points()` and ids stay valid
+template<typename Tp, typename Index = uint32_t>
+class Delaunay {
+private:
+    typedef Point<Tp, 2> Pnt;
+    typedef TriangleMesh<Index> Mesh;
+
+public:
+    static const Index NONE = Mesh::NONE;
+
+    enum LocateType : int {
+        IN_TRIANGLE, ON_EDGE, ON_VERTEX, OUT_OF_HULL
+    };
+
+public:
+    Delaunay()
+        : hint_(0)
+        , seed_(1)
+    {}
+
+    explicit Delaunay(const std::vector<Pnt>& points)
+        : hint_(0)
+        , seed_(1)
+    {
+        Build(points);
+    }
+
+    // vertex ids are indices in `points`
+    // duplicates and points of degenerate (collinear) input aren't part of any triangle
+    void Build(const std::vector<Pnt>& points) {
+        points_ = points;
+        removed_.assign(points_.size(), 0);
+        Rebuild();
+    }
+
+    // returns id of inserted vertex, or id of the existing vertex with the same coordinates
+    // the point of a duplicate isn't added to `Points()`
+    Index Insert(const Pnt& p) {
+        if (mesh_.TrianglesCount() == 0) {
+            for (size_t v = 0; v < points_.size(); ++v) {
+                if (!removed_[v] && points_[v] == p)
+                    return static_cast<Index>(v);
+            }
+
+            points_.push_back(p);
+            removed_.push_back(0);
+            Rebuild();
+            return static_cast<Index>(points_.size() - 1);
+        }
+
+        Index v = static_cast<Index>(points_.size());
+        points_.push_back(p);
+        removed_.push_back(0);
+        mesh_.ResizeVertices(points_.size());
+
+        Index res = InsertVertex(v);
+        if (res != v) {
+            points_.pop_back();
+            removed_.pop_back();
+            mesh_.ResizeVertices(points_.size());
+        }
+        return res;
+    }
+
+    // removes vertex `v`, the hole is triangulated by ears taken in order of power of `v`
+    // with respect to their circumcircles (Devillers), it takes O(d log d) for degree d
+    // a hull vertex leaves a pocket between its neighbours and the new hull, which is
+    // filled by convex ears and made Delaunay by flips
+    // a duplicate of `v` left out of the mesh takes its place, it's looked up among
+    // the vertices left out
+    void Remove(Index v) {
+        assert(v < points_.size());
+        if (removed_[v])
+            return;
+
+        removed_[v] = 1;
+        if (mesh_.VertexEdge(v) == NONE)
+            return;
+
+        RemoveVertex(v);
+        for (size_t i = 0; i < detached_.size(); ++i) {
+            Index w = detached_[i];
+            if (!removed_[w] && points_[w] == points_[v] && mesh_.TrianglesCount() > 0) {
+                detached_.erase(detached_.begin() + i);
+                InsertVertex(w);
+                break;
+            }
+        }
+    }
+
+    bool IsRemoved(Index v) const {
+        return removed_[v];
+    }
+
+    // removes vertices `removed`, then inserts `inserted` in Hilbert order,
+    // so every walk starts near the previous point; ids[i] is the id of inserted[i]
+    void Update(const std::vector<Index>& removed, const std::vector<Pnt>& inserted,
+                std::vector<Index>& ids)
+    {
+        for (Index v: removed)
+            Remove(v);
+
+        ids.resize(inserted.size());
+        for (size_t i: HilbertOrder(inserted))
+            ids[i] = Insert(inserted[i]);
+    }
+
+    // kinetic update: moves every point to `positions[v]` keeping the mesh Delaunay
+    // edges failing the incircle test are found in parallel and flipped; vertices of
+    // inverted triangles and of reflex hull corners are taken back to their old points
+    // until the mesh is valid, then they are removed and inserted at the new points,
+    // so besides the linear check the work is proportional to the count of changes
+    // vertices left out of the mesh as duplicates are inserted at their new points,
+    // unless they are still duplicates
+    void Move(const std::vector<Pnt>& positions, size_t threads = 1) {
+        assert(positions.size() == points_.size());
+        if (mesh_.TrianglesCount() == 0) {
+            points_ = positions;
+            Rebuild();
+            return;
+        }
+
+        std::vector<Pnt> previous(positions);
+        previous.swap(points_);
+
+        std::vector<Index> invalid;
+        CheckMesh(invalid, stack_, threads);
+
+        // taking a vertex back touches only its triangles and hull corners,
+        // the old points are valid, so it ends before every vertex is taken back
+        std::vector<char> is_back(points_.size(), 0);
+        std::vector<Index> back;
+        while (!invalid.empty()) {
+            size_t first = back.size();
+            for (Index v: invalid) {
+                if (!is_back[v]) {
+                    is_back[v] = 1;
+                    back.push_back(v);
+                    points_[v] = previous[v];
+                }
+            }
+            assert(back.size() > first);
+
+            invalid.clear();
+            for (size_t i = first; i < back.size(); ++i)
+                CheckStar(back[i], invalid);
+        }
+
+        LegalizeEdges();
+        for (Index v: back) {
+            if (mesh_.VertexEdge(v) != NONE)
+                RemoveVertex(v);
+            points_[v] = positions[v];
+        }
+
+        if (mesh_.TrianglesCount() == 0) {
+            Rebuild();
+            return;
+        }
+        for (Index v: back)
+            InsertVertex(v);
+        for (Index v: detached_)
+            InsertVertex(v);
+        Detach();
+    }
+
+    // finds position of `p`, `h` is set to:
+    // IN_TRIANGLE - first half-edge of the triangle
+    // ON_EDGE - half-edge containing `p`
+    // ON_VERTEX - half-edge outgoing from the vertex equal to `p`
+    // OUT_OF_HULL - convex hull half-edge visible from `p`
+    LocateType Locate(const Pnt& p, Index& h) {
+        assert(mesh_.TrianglesCount() > 0);
+
+        Index t = hint_ < mesh_.TrianglesCount() ? hint_ : 0;
+        Index came = NONE;
+        size_t max_steps = 4 * mesh_.TrianglesCount() + 16;
+
+        for (size_t steps = 0; steps < max_steps; ++steps) {
+            Index offset = NextRandom() % 3;
+            bool moved = false;
+            for (Index k = 0; k < 3 && !moved; ++k) {
+                Index e = 3 * t + (k + offset) % 3;
+                if (e == came)
+                    continue;
+
+                if (Orientation(From(e), To(e), p) < 0) {
+                    if (mesh_.Twin(e) == NONE) {
+                        hint_ = t;
+                        h = e;
+                        return OUT_OF_HULL;
+                    }
+                    came = mesh_.Twin(e);
+                    t = came / 3;
+                    moved = true;
+                }
+            }
+
+            if (!moved) {
+                hint_ = t;
+                return Classify(t, p, h);
+            }
+        }
+
+        // walk cycles only on inexact predicates, fall back to the full scan
+        for (t = 0; t < mesh_.TrianglesCount(); ++t) {
+            bool inside = true;
+            for (Index e = 3 * t; e < 3 * t + 3 && inside; ++e) {
+                if (Orientation(From(e), To(e), p) < 0) {
+                    inside = false;
+                    if (mesh_.Twin(e) == NONE) {
+                        hint_ = t;
+                        h = e;
+                        return OUT_OF_HULL;
+                    }
+                }
+            }
+
+            if (inside) {
+                hint_ = t;
+                return Classify(t, p, h);
+            }
+        }
+
+        assert(false);
+        return OUT_OF_HULL;
+    }
+
+    const Mesh& GetMesh() const {
+        return mesh_;
+    }
+
+    size_t TrianglesCount() const {
+        return mesh_.TrianglesCount();
+    }
+
+    size_t PointsCount() const {
+        return points_.size();
+    }
+
+    const Pnt& GetPoint(size_t v) const {
+        return points_[v];
+    }
+
+    const std::vector<Pnt>& Points() const {
+        return points_;
+    }
+
+private:
+    struct FanEdge {
+        FanEdge(Index from, Index to, Index twin)
+            : from(from)
+            , to(to)
+            , twin(twin)
+        {}
+
+        Index from;
+        Index to;
+        Index twin;
+    };
+
+    const Pnt& From(Index h) const {
+        return points_[mesh_.Origin(h)];
+    }
+
+    const Pnt& To(Index h) const {
+        return points_[mesh_.Target(h)];
+    }
+
+    // vertex of the triangle of `h` opposite to it
+    const Pnt& Far(Index h) const {
+        return points_[mesh_.Origin(Mesh::Prev(h))];
+    }
+
+    Index NextRandom() {
+        seed_ ^= seed_ << 13;
+        seed_ ^= seed_ >> 7;
+        seed_ ^= seed_ << 17;
+        return static_cast<Index>(seed_);
+    }
+
+    LocateType Classify(Index t, const Pnt& p, Index& h) const {
+        Index on_edge = NONE;
+        for (Index e = 3 * t; e < 3 * t + 3; ++e) {
+            if (From(e) == p) {
+                h = e;
+                return ON_VERTEX;
+            }
+
+            if (Orientation(From(e), To(e), p) == 0)
+                on_edge = e;
+        }
+
+        h = on_edge == NONE ? 3 * t : on_edge;
+        return on_edge == NONE ? IN_TRIANGLE : ON_EDGE;
+    }
+
+    // triangulates all points, which aren't removed
+    void Rebuild() {
+        mesh_.Clear();
+        mesh_.ResizeVertices(points_.size());
+        mesh_.Reserve(2 * points_.size());
+        hint_ = 0;
+
+        std::vector<size_t> order = HilbertOrder(points_);
+        order.erase(std::remove_if(order.begin(), order.end(), [this] (size_t id) {
+            return removed_[id] != 0;
+        }), order.end());
+
+        Index a, b, c;
+        if (FindFirstTriangle(order, a, b, c)) {
+            for (size_t id: order) {
+                if (id != a && id != b && id != c)
+                    InsertVertex(static_cast<Index>(id));
+            }
+        }
+        Detach();
+    }
+
+    // collects vertices left out of the mesh
+    void Detach() {
+        detached_.clear();
+        for (size_t v = 0; v < points_.size(); ++v) {
+            if (!removed_[v] && mesh_.VertexEdge(v) == NONE)
+                detached_.push_back(static_cast<Index>(v));
+        }
+    }
+
+    bool FindFirstTriangle(const std::vector<size_t>& order, Index& a, Index& b, Index& c) {
+        if (order.empty())
+            return false;
+
+        a = order[0];
+        size_t i = 1;
+        while (i < order.size() && points_[order[i]] == points_[a])
+            ++i;
+        if (i == order.size())
+            return false;
+
+        b = order[i];
+        while (i < order.size() && Orientation(points_[a], points_[b], points_[order[i]]) == 0)
+            ++i;
+        if (i == order.size())
+            return false;
+
+        c = order[i];
+        if (Orientation(points_[a], points_[b], points_[c]) < 0)
+            std::swap(b, c);
+
+        mesh_.AddTriangle(a, b, c);
+        return true;
+    }
+
+    Index InsertVertex(Index v) {
+        const Pnt& p = points_[v];
+        Index h;
+        LocateType type = Locate(p, h);
+
+        fan_.clear();
+        reuse_.clear();
+        bool closed = true;
+
+        if (type == ON_VERTEX) {
+            return mesh_.Origin(h);
+        } else if (type == IN_TRIANGLE) {
+            for (Index e = h; e < h + 3; ++e)
+                fan_.push_back(FanEdge(mesh_.Origin(e), mesh_.Target(e), mesh_.Twin(e)));
+            reuse_.push_back(h / 3);
+        } else if (type == ON_EDGE) {
+            Index g = mesh_.Twin(h);
+            for (Index e: {Mesh::Next(h), Mesh::Prev(h)})
+                fan_.push_back(FanEdge(mesh_.Origin(e), mesh_.Target(e), mesh_.Twin(e)));
+            reuse_.push_back(h / 3);
+
+            if (g == NONE) {
+                closed = false;
+            } else {
+                for (Index e: {Mesh::Next(g), Mesh::Prev(g)})
+                    fan_.push_back(FanEdge(mesh_.Origin(e), mesh_.Target(e), mesh_.Twin(e)));
+                reuse_.push_back(g / 3);
+            }
+        } else {
+            // hull edges visible from `p` form a chain [first, last]
+            Index first = h;
+            Index last = h;
+            for (Index e = mesh_.PrevBoundary(first); e != h && Orientation(From(e), To(e), p) < 0;
+                    e = mesh_.PrevBoundary(e))
+            {
+                first = e;
+            }
+            for (Index e = mesh_.NextBoundary(last); e != first && Orientation(From(e), To(e), p) < 0;
+                    e = mesh_.NextBoundary(e))
+            {
+                last = e;
+            }
+
+            for (Index e = last; ; e = mesh_.PrevBoundary(e)) {
+                fan_.push_back(FanEdge(mesh_.Target(e), mesh_.Origin(e), e));
+                if (e == first)
+                    break;
+            }
+            closed = false;
+        }
+
+        MakeFan(v, closed);
+        return v;
+    }
+
+    // triangulates star-shaped polygon `fan_` around vertex `v`
+    // fan edges must be consecutive in counterclockwise order around `v`
+    void MakeFan(Index v, bool closed) {
+        size_t k = fan_.size();
+        tri_.resize(k);
+        for (size_t i = 0; i < k; ++i)
+            tri_[i] = i < reuse_.size() ? reuse_[i] : mesh_.AddTriangle(v, v, v);
+
+        for (size_t i = 0; i < k; ++i) {
+            Index t = tri_[i];
+            Index next_t = i + 1 < k ? tri_[i + 1] : (closed ? tri_[0] : NONE);
+            Index prev_t = i > 0 ? tri_[i - 1] : (closed ? tri_[k - 1] : NONE);
+
+            mesh_.SetTriangle(t, fan_[i].from, fan_[i].to, v);
+            mesh_.SetTwin(3 * t, fan_[i].twin);
+            mesh_.SetTwin(3 * t + 1, next_t == NONE ? NONE : 3 * next_t + 2);
+            mesh_.SetTwin(3 * t + 2, prev_t == NONE ? NONE : 3 * prev_t + 1);
+            stack_.push_back(3 * t);
+        }
+
+        hint_ = tri_[0];
+        Legalize();
+    }
+
+    // restores Delaunay property, every half-edge in `stack_` is opposite to the inserted vertex
+    void Legalize() {
+        while (!stack_.empty()) {
+            Index h = stack_.back();
+            stack_.pop_back();
+
+            Index g = mesh_.Twin(h);
+            if (g == NONE)
+                continue;
+
+            const Pnt& a = From(h);
+            const Pnt& b = To(h);
+            const Pnt& c = points_[mesh_.Origin(Mesh::Prev(h))];
+            const Pnt& d = points_[mesh_.Origin(Mesh::Prev(g))];
+            if (InCircle(a, b, c, d) > 0) {
+                Flip(h);
+                stack_.push_back(3 * (h / 3) + 1);
+                stack_.push_back(3 * (g / 3));
+            }
+        }
+    }
+
+    // power of `p` with respect to circumcircle of counterclockwise (a, b, c),
+    // negative inside the circle
+    static double Power(const Pnt& a, const Pnt& b, const Pnt& c, const Pnt& p) {
+        double adx = static_cast<double>(a.x()) - p.x(), ady = static_cast<double>(a.y()) - p.y();
+        double bdx = static_cast<double>(b.x()) - p.x(), bdy = static_cast<double>(b.y()) - p.y();
+        double cdx = static_cast<double>(c.x()) - p.x(), cdy = static_cast<double>(c.y()) - p.y();
+
+        double det = (adx * adx + ady * ady) * (bdx * cdy - cdx * bdy)
+                   + (bdx * bdx + bdy * bdy) * (cdx * ady - adx * cdy)
+                   + (cdx * cdx + cdy * cdy) * (adx * bdy - bdx * ady);
+        double orientation = (bdx - adx) * (cdy - ady) - (bdy - ady) * (cdx - adx);
+        return -det / orientation;
+    }
+
+    void RemoveVertex(Index v) {
+        struct Ear {
+            double power;
+            Index id;
+            Index stamp;
+
+            // the ear of the greatest power is Delaunay
+            bool operator<(const Ear& oth) const {
+                return power < oth.power;
+            }
+        };
+
+        // link_[i] is the i-th neighbour of `v` counterclockwise, outer_[i] is the twin
+        // of the hole edge (link_[i], link_[i + 1]), reuse_ are triangles of the star
+        link_.clear();
+        outer_.clear();
+        reuse_.clear();
+        bool closed = true;
+        for (Index h: mesh_.OutgoingEdges(v)) {
+            link_.push_back(mesh_.Target(h));
+            outer_.push_back(mesh_.Twin(Mesh::Next(h)));
+            reuse_.push_back(h / 3);
+            if (mesh_.Twin(Mesh::Prev(h)) == NONE) {
+                link_.push_back(mesh_.Origin(Mesh::Prev(h)));
+                outer_.push_back(NONE);
+                closed = false;
+            }
+        }
+
+        size_t k = link_.size();
+        prev_.resize(k);
+        next_.resize(k);
+        stamp_.assign(k, 0);
+        for (size_t i = 0; i < k; ++i) {
+            prev_[i] = i > 0 ? i - 1 : (closed ? k - 1 : NONE);
+            next_[i] = i + 1 < k ? i + 1 : (closed ? 0 : NONE);
+            mesh_.SetVertexEdge(link_[i], NONE);
+        }
+        mesh_.SetVertexEdge(v, NONE);
+
+        std::priority_queue<Ear> ears;
+        auto push_ear = [&] (Index i) {
+            ++stamp_[i];
+            if (prev_[i] == NONE || next_[i] == NONE)
+                return;
+
+            const Pnt& a = points_[link_[prev_[i]]];
+            const Pnt& b = points_[link_[i]];
+            const Pnt& c = points_[link_[next_[i]]];
+            if (Orientation(a, b, c) > 0)
+                ears.push(Ear{Power(a, b, c, points_[v]), i, stamp_[i]});
+        };
+        for (Index i = 0; i < k; ++i)
+            push_ear(i);
+
+        // triangle (a, b, c) of hole vertices, (c, a) is a hole edge if `last` is NONE
+        size_t used = 0;
+        auto add_triangle = [&] (Index a, Index b, Index c, Index last) {
+            Index t = reuse_[used++];
+            mesh_.SetTriangle(t, link_[a], link_[b], link_[c]);
+            mesh_.SetTwin(3 * t, outer_[a]);
+            mesh_.SetTwin(3 * t + 1, outer_[b]);
+            mesh_.SetTwin(3 * t + 2, last);
+            for (Index e = 3 * t; e < 3 * t + 3; ++e)
+                stack_.push_back(e);
+            return t;
+        };
+
+        size_t left = k;
+        while (!ears.empty() && (!closed || left > 3)) {
+            Ear ear = ears.top();
+            ears.pop();
+            if (ear.stamp != stamp_[ear.id])
+                continue;
+
+            Index b = ear.id;
+            Index a = prev_[b];
+            Index c = next_[b];
+            outer_[a] = 3 * add_triangle(a, b, c, NONE) + 2;
+
+            next_[a] = c;
+            prev_[c] = a;
+            stamp_[b] = NONE;
+            --left;
+            push_ear(a);
+            push_ear(c);
+        }
+
+        if (closed) {
+            assert(left == 3);
+            Index a = 0;
+            while (stamp_[a] == NONE)
+                ++a;
+            Index c = prev_[a];
+            add_triangle(a, next_[a], c, outer_[c]);
+        } else {
+            // the rest of the chain is the new hull
+            for (Index i = 0; next_[i] != NONE; i = next_[i]) {
+                if (outer_[i] != NONE) {
+                    mesh_.SetTwin(outer_[i], NONE);
+                    mesh_.SetVertexEdge(link_[next_[i]], outer_[i]);
+                    mesh_.SetVertexEdge(link_[i], Mesh::Next(outer_[i]));
+                }
+            }
+        }
+
+        LegalizeEdges();
+        if (used > 0)
+            hint_ = reuse_[0];
+
+        // unused triangles of the star are filled by the last ones
+        std::sort(reuse_.begin() + used, reuse_.end());
+        for (size_t i = reuse_.size(); i > used; --i) {
+            Index last = static_cast<Index>(mesh_.TrianglesCount() - 1);
+            if (reuse_[i - 1] != last)
+                mesh_.MoveTriangle(last, reuse_[i - 1]);
+            if (hint_ == last)
+                hint_ = reuse_[i - 1];
+            mesh_.ResizeTriangles(last);
+        }
+        if (hint_ >= mesh_.TrianglesCount())
+            hint_ = 0;
+    }
+
+    bool IsInverted(Index t) const {
+        return Orientation(From(3 * t), From(3 * t + 1), From(3 * t + 2)) <= 0;
+    }
+
+    // hull turns right at the end of boundary half-edge `h`
+    bool IsReflex(Index h) const {
+        return Orientation(From(h), To(h), To(mesh_.NextBoundary(h))) < 0;
+    }
+
+    void PushCorner(Index h, std::vector<Index>& invalid) const {
+        invalid.push_back(mesh_.Origin(h));
+        invalid.push_back(mesh_.Target(h));
+        invalid.push_back(mesh_.Target(mesh_.NextBoundary(h)));
+    }
+
+    // finds vertices of inverted triangles and reflex hull corners,
+    // and edges which aren't locally Delaunay, one chunk of triangles per thread
+    void CheckMesh(std::vector<Index>& invalid, std::vector<Index>& edges, size_t threads) const {
+        size_t count = mesh_.TrianglesCount();
+        size_t chunks = ThreadsCount(threads, count);
+        std::vector<std::vector<Index>> chunk_invalid(chunks);
+        std::vector<std::vector<Index>> chunk_edges(chunks);
+
+        ParallelChunks(count, chunks, [&] (size_t chunk, size_t begin, size_t end) {
+            for (Index t = static_cast<Index>(begin); t < end; ++t) {
+                if (IsInverted(t)) {
+                    for (Index e = 3 * t; e < 3 * t + 3; ++e)
+                        chunk_invalid[chunk].push_back(mesh_.Origin(e));
+                }
+
+                for (Index e = 3 * t; e < 3 * t + 3; ++e) {
+                    Index g = mesh_.Twin(e);
+                    if (g == NONE) {
+                        if (IsReflex(e))
+                            PushCorner(e, chunk_invalid[chunk]);
+                    } else if (e < g && InCircle(From(e), To(e), Far(e), Far(g)) > 0) {
+                        chunk_edges[chunk].push_back(e);
+                    }
+                }
+            }
+        });
+
+        invalid.clear();
+        for (const auto& part: chunk_invalid)
+            invalid.insert(invalid.end(), part.begin(), part.end());
+        for (const auto& part: chunk_edges)
+            edges.insert(edges.end(), part.begin(), part.end());
+    }
+
+    // appends vertices of inverted triangles and reflex hull corners around `v`,
+    // all edges of its triangles are checked by the next `LegalizeEdges`
+    void CheckStar(Index v, std::vector<Index>& invalid) {
+        for (Index h: mesh_.OutgoingEdges(v)) {
+            Index t = h / 3;
+            if (IsInverted(t)) {
+                for (Index e = 3 * t; e < 3 * t + 3; ++e)
+                    invalid.push_back(mesh_.Origin(e));
+            }
+
+            for (Index e = 3 * t; e < 3 * t + 3; ++e)
+                stack_.push_back(e);
+
+            // corners at `v` and at its hull neighbours
+            if (mesh_.Twin(h) == NONE) {
+                Index prev = mesh_.PrevBoundary(h);
+                for (Index e: {mesh_.PrevBoundary(prev), prev, h}) {
+                    if (IsReflex(e))
+                        PushCorner(e, invalid);
+                }
+            }
+        }
+    }
+
+    // flips every edge of `stack_`, which isn't locally Delaunay, and checks
+    // the edges of the flipped quadrilateral again
+    void LegalizeEdges() {
+        while (!stack_.empty()) {
+            Index h = stack_.back();
+            stack_.pop_back();
+
+            Index g = mesh_.Twin(h);
+            if (g == NONE)
+                continue;
+
+            if (InCircle(From(h), To(h), Far(h), Far(g)) > 0) {
+                Flip(h);
+                for (Index e: {3 * (h / 3), 3 * (h / 3) + 1, 3 * (g / 3), 3 * (g / 3) + 1})
+                    stack_.push_back(e);
+            }
+        }
+    }
+
+    // replaces edge `h` (a, b) of triangles (a, b, c), (b, a, d) by (c, d)
+    // the result triangles are (c, a, d) and (d, b, c)
+    void Flip(Index h) {
+        Index g = mesh_.Twin(h);
+        Index t = h / 3;
+        Index s = g / 3;
+
+        Index a = mesh_.Origin(h);
+        Index b = mesh_.Target(h);
+        Index c = mesh_.Origin(Mesh::Prev(h));
+        Index d = mesh_.Origin(Mesh::Prev(g));
+
+        Index tb = mesh_.Twin(Mesh::Next(h));
+        Index tc = mesh_.Twin(Mesh::Prev(h));
+        Index ga = mesh_.Twin(Mesh::Next(g));
+        Index gd = mesh_.Twin(Mesh::Prev(g));
+
+        mesh_.SetTriangle(t, c, a, d);
+        mesh_.SetTriangle(s, d, b, c);
+
+        mesh_.SetTwin(3 * t, tc);
+        mesh_.SetTwin(3 * t + 1, ga);
+        mesh_.SetTwin(3 * t + 2, 3 * s + 2);
+        mesh_.SetTwin(3 * s, gd);
+        mesh_.SetTwin(3 * s + 1, tb);
+    }
+
+private:
+    std::vector<Pnt> points_;
+    std::vector<char> removed_;
+    // vertices left out of the mesh: duplicates and points of degenerate input
+    std::vector<Index> detached_;
+    Mesh mesh_;
+    Index hint_;
+    unsigned long long seed_;
+
+    // scratch buffers of insertion
+    std::vector<FanEdge> fan_;
+    std::vector<Index> reuse_;
+    std::vector<Index> tri_;
+    std::vector<Index> stack_;
+
+    // scratch buffers of removal
+    std::vector<Index> link_;
+    std::vector<Index> outer_;
+    std::vector<Index> prev_;
+    std::vector<Index> next_;
+    std::vector<Index> stamp_;
+};
+
+template<typename Tp, typename Index>
+const Index Delaunay<Tp, Index>::NONE;
+
+template<typename Tp, typename Index>
+std::ostream& operator << (std::ostream& out, const Delaunay<Tp, Index>& delaunay) {
+    return out << delaunay.GetMesh();
+}
+
+} // namespace geometry
+
+#endif // DELAUNAY_H
@@ -0,0 +1,498 @@
+#ifndef DELAUNAY3_H
+#define DELAUNAY3_H
+#include <iostream>
+#include <vector>
+#include <cassert>
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include "point.h"
+#include "predicates.h"
+#include "spatial_sort.h"
+
+namespace geometry {
+
+// incremental Delaunay tetrahedralization (Bowyer-Watson)
+//
+// tetrahedron `t` consists of vertices 4t, ..., 4t + 3 and is positive (see `Orientation`),
+// its neighbour 4t + k lies across the face opposite to vertex k
+// the hull is closed by ghost tetrahedra: every hull face is connected to INFINITE vertex,
+// so every tetrahedron has all four neighbours
+// integer coordinates must not exceed `MaxInSphereCoordinate()` by absolute value,
+// then the predicates are exact
+template<typename Tp, typename Index = uint32_t>
+class Delaunay3 {
+private:
+    typedef Point<Tp, 3> Pnt;
+
+public:
+    static const Index NONE = static_cast<Index>(-1);
+    static const Index INFINITE = static_cast<Index>(-2);
+
+public:
+    Delaunay3()
+        : hint_(0)
+        , stamp_(0)
+        , seed_(1)
+    {}
+
+    explicit Delaunay3(const std::vector<Pnt>& points)
+        : hint_(0)
+        , stamp_(0)
+        , seed_(1)
+    {
+        Build(points);
+    }
+
+    // vertex ids are indices in `points`
+    // duplicates and points of degenerate (coplanar) input aren't part of any tetrahedron
+    void Build(const std::vector<Pnt>& points) {
+        assert(std::all_of(points.begin(), points.end(), [] (const Pnt& p) {
+            return InRange(p, std::is_integral<Tp>());
+        }));
+        points_ = points;
+        vertices_.clear();
+        neighbours_.clear();
+        marks_.clear();
+        free_.clear();
+        vertices_.reserve(4 * 7 * points_.size());
+        neighbours_.reserve(4 * 7 * points_.size());
+        marks_.reserve(7 * points_.size());
+        hint_ = 0;
+
+        std::vector<size_t> order = HilbertOrder(points_);
+        Index first[4];
+        if (!FindFirstTetrahedron(order, first))
+            return;
+
+        for (size_t id: order) {
+            if (std::find(first, first + 4, id) == first + 4)
+                InsertVertex(static_cast<Index>(id));
+        }
+
+        Compact();
+    }
+
+    // returns id of inserted vertex, or id of the existing vertex with the same coordinates
+    // removed tetrahedra are reused by the next insertions
+    // the point of a duplicate isn't added to `Points()`
+    Index Insert(const Pnt& p) {
+        if (vertices_.empty()) {
+            for (size_t v = 0; v < points_.size(); ++v) {
+                if (points_[v] == p)
+                    return static_cast<Index>(v);
+            }
+
+            std::vector<Pnt> points(points_);
+            points.push_back(p);
+            Build(points);
+            return static_cast<Index>(points_.size() - 1);
+        }
+
+        assert(InRange(p, std::is_integral<Tp>()));
+        Index v = static_cast<Index>(points_.size());
+        points_.push_back(p);
+        Index res = InsertVertex(v);
+        if (res != v)
+            points_.pop_back();
+        return res;
+    }
+
+    // count of tetrahedra including ghost and removed ones
+    size_t TetrahedraCount() const {
+        return vertices_.size() / 4;
+    }
+
+    // returns vertex `k` of tetrahedron `t`, INFINITE for ghost vertex, NONE for removed tetrahedron
+    Index Vertex(size_t t, size_t k) const {
+        assert(k < 4);
+        return vertices_[4 * t + k];
+    }
+
+    // returns tetrahedron across the face opposite to vertex `k` of tetrahedron `t`
+    Index Neighbour(size_t t, size_t k) const {
+        assert(k < 4);
+        return neighbours_[4 * t + k];
+    }
+
+    bool IsGhost(size_t t) const {
+        return GhostPosition(t) < 4;
+    }
+
+    bool IsRemoved(size_t t) const {
+        return vertices_[4 * t] == NONE;
+    }
+
+    // returns vertex quadruples of finite tetrahedra
+    std::vector<Index> FiniteTetrahedra() const {
+        std::vector<Index> res;
+        for (size_t t = 0; t < TetrahedraCount(); ++t) {
+            if (!IsRemoved(t) && !IsGhost(t))
+                res.insert(res.end(), vertices_.begin() + 4 * t, vertices_.begin() + 4 * t + 4);
+        }
+        return res;
+    }
+
+    size_t PointsCount() const {
+        return points_.size();
+    }
+
+    const Pnt& GetPoint(size_t v) const {
+        return points_[v];
+    }
+
+    const std::vector<Pnt>& Points() const {
+        return points_;
+    }
+
+private:
+    struct Facet {
+        Index v[4];     // vertices of the removed tetrahedron, where the new vertex replaces `k`
+        size_t k;       // the facet is opposite to vertex `k`
+        Index outer;    // tetrahedron across the facet
+        size_t back;    // face of `outer`, which looks back
+    };
+
+    struct FaceKey {
+        bool operator<(const FaceKey& oth) const {
+            return u < oth.u || (u == oth.u && v < oth.v);
+        }
+
+        Index u, v;
+        Index t;
+        size_t k;
+    };
+
+    // returns position of INFINITE vertex in tetrahedron `t` or 4
+    size_t GhostPosition(size_t t) const {
+        for (size_t k = 0; k < 4; ++k) {
+            if (vertices_[4 * t + k] == INFINITE)
+                return k;
+        }
+        return 4;
+    }
+
+    size_t NextRandom() {
+        seed_ ^= seed_ << 13;
+        seed_ ^= seed_ >> 7;
+        seed_ ^= seed_ << 17;
+        return static_cast<size_t>(seed_);
+    }
+
+    // whether `InSphere` is exact for integer coordinates of `p`
+    static bool InRange(const Pnt& p, std::true_type) {
+        long long max_coordinate = MaxInSphereCoordinate();
+        for (size_t i = 0; i < 3; ++i) {
+            if (p.Get(i) > max_coordinate || p.Get(i) < -max_coordinate)
+                return false;
+        }
+        return true;
+    }
+
+    static bool InRange(const Pnt&, std::false_type) {
+        return true;
+    }
+
+    // orientation of tetrahedron `t`, which vertex `k` is replaced by `p`
+    int OrientationWith(size_t t, size_t k, const Pnt& p) const {
+        const Pnt* q[4];
+        for (size_t i = 0; i < 4; ++i)
+            q[i] = i == k ? &p : &points_[vertices_[4 * t + i]];
+        return Orientation(*q[0], *q[1], *q[2], *q[3]);
+    }
+
+    int InSphereOf(size_t t, const Pnt& p) const {
+        const Index* v = &vertices_[4 * t];
+        return InSphere(points_[v[0]], points_[v[1]], points_[v[2]], points_[v[3]], p);
+    }
+
+    // `p` conflicts with ghost tetrahedron, if it lies beyond its hull face
+    // or lies in the face plane inside the circumcircle of the face
+    bool InConflict(size_t t, const Pnt& p) const {
+        size_t ghost = GhostPosition(t);
+        if (ghost == 4)
+            return InSphereOf(t, p) > 0;
+
+        int o = OrientationWith(t, ghost, p);
+        if (o != 0)
+            return o > 0;
+        return InSphereOf(neighbours_[4 * t + ghost], p) > 0;
+    }
+
+    bool FindFirstTetrahedron(const std::vector<size_t>& order, Index (&first)[4]) {
+        if (order.empty())
+            return false;
+
+        size_t i = 0;
+        first[0] = order[i++];
+        while (i < order.size() && points_[order[i]] == points_[first[0]])
+            ++i;
+        if (i == order.size())
+            return false;
+
+        first[1] = order[i++];
+        while (i < order.size() && Collinear(points_[first[0]], points_[first[1]], points_[order[i]]))
+            ++i;
+        if (i == order.size())
+            return false;
+
+        first[2] = order[i++];
+        while (i < order.size() &&
+               Orientation(points_[first[0]], points_[first[1]], points_[first[2]], points_[order[i]]) == 0)
+        {
+            ++i;
+        }
+        if (i == order.size())
+            return false;
+
+        first[3] = order[i];
+        if (Orientation(points_[first[0]], points_[first[1]], points_[first[2]], points_[first[3]]) < 0)
+            std::swap(first[0], first[1]);
+
+        // finite tetrahedron 0 and ghost tetrahedron k + 1 across its face k
+        // swapping two vertices keeps ghosts positive, when INFINITE replaces the inner vertex
+        vertices_.assign(first, first + 4);
+        neighbours_.assign(4, NONE);
+        for (size_t k = 0; k < 4; ++k) {
+            Index v[4] = {first[0], first[1], first[2], first[3]};
+            v[k] = INFINITE;
+            std::swap(v[(k + 1) % 4], v[(k + 2) % 4]);
+            vertices_.insert(vertices_.end(), v, v + 4);
+            neighbours_.insert(neighbours_.end(), 4, NONE);
+            neighbours_[k] = k + 1;
+            neighbours_[4 * (k + 1) + k] = 0;
+        }
+
+        // ghosts share faces containing INFINITE vertex
+        for (size_t t = 1; t <= 4; ++t) {
+            for (size_t k = 0; k < 4; ++k) {
+                if (neighbours_[4 * t + k] != NONE)
+                    continue;
+
+                for (size_t s = 1; s <= 4; ++s) {
+                    if (s != t && !Contains(s, vertices_[4 * t + k]))
+                        neighbours_[4 * t + k] = s;
+                }
+            }
+        }
+        marks_.assign(TetrahedraCount(), 0);
+        return true;
+    }
+
+    bool Contains(size_t t, Index v) const {
+        return std::find(vertices_.begin() + 4 * t, vertices_.begin() + 4 * t + 4, v) !=
+               vertices_.begin() + 4 * t + 4;
+    }
+
+    // returns finite tetrahedron containing `p` or ghost tetrahedron conflicting with it
+    Index Locate(const Pnt& p) {
+        Index t = hint_;
+        if (t >= TetrahedraCount() || IsRemoved(t))
+            t = 0;
+        while (IsRemoved(t))
+            ++t;
+        if (IsGhost(t))
+            t = neighbours_[4 * t + GhostPosition(t)];
+
+        Index came = NONE;
+        size_t max_steps = TetrahedraCount() + 16;
+        for (size_t steps = 0; steps < max_steps; ++steps) {
+            size_t offset = NextRandom() % 4;
+            bool moved = false;
+            for (size_t i = 0; i < 4 && !moved; ++i) {
+                size_t k = (i + offset) % 4;
+                Index n = neighbours_[4 * t + k];
+                if (n == came || OrientationWith(t, k, p) >= 0)
+                    continue;
+
+                if (IsGhost(n))
+                    return n;
+                came = t;
+                t = n;
+                moved = true;
+            }
+
+            if (!moved)
+                return t;
+        }
+
+        // walk cycles only on inexact predicates, fall back to the full scan
+        for (t = 0; t < TetrahedraCount(); ++t) {
+            if (!IsRemoved(t) && InConflict(t, p))
+                return t;
+        }
+
+        assert(false);
+        return 0;
+    }
+
+    Index NewTetrahedron() {
+        if (!free_.empty()) {
+            Index t = free_.back();
+            free_.pop_back();
+            return t;
+        }
+
+        vertices_.resize(vertices_.size() + 4);
+        neighbours_.resize(neighbours_.size() + 4);
+        marks_.push_back(0);
+        return static_cast<Index>(TetrahedraCount() - 1);
+    }
+
+    Index InsertVertex(Index v) {
+        const Pnt& p = points_[v];
+        Index t = Locate(p);
+
+        if (!IsGhost(t)) {
+            for (size_t k = 0; k < 4; ++k) {
+                if (points_[vertices_[4 * t + k]] == p)
+                    return vertices_[4 * t + k];
+            }
+        }
+
+        // conflict region by breadth first search, marks: stamp_ - conflict, stamp_ + 1 - not
+        stamp_ += 2;
+        conflict_.assign(1, t);
+        marks_[t] = stamp_;
+        for (size_t i = 0; i < conflict_.size(); ++i) {
+            Index s = conflict_[i];
+            for (size_t k = 0; k < 4; ++k) {
+                Index n = neighbours_[4 * s + k];
+                if (marks_[n] == stamp_ || marks_[n] == stamp_ + 1)
+                    continue;
+
+                if (InConflict(n, p)) {
+                    marks_[n] = stamp_;
+                    conflict_.push_back(n);
+                } else {
+                    marks_[n] = stamp_ + 1;
+                }
+            }
+        }
+
+        facets_.clear();
+        for (Index s: conflict_) {
+            for (size_t k = 0; k < 4; ++k) {
+                Index n = neighbours_[4 * s + k];
+                if (marks_[n] == stamp_)
+                    continue;
+
+                Facet f;
+                std::copy(vertices_.begin() + 4 * s, vertices_.begin() + 4 * s + 4, f.v);
+                f.v[k] = v;
+                f.k = k;
+                f.outer = n;
+                f.back = 0;
+                while (neighbours_[4 * n + f.back] != s)
+                    ++f.back;
+                facets_.push_back(f);
+            }
+        }
+
+        // every boundary facet of the cavity with `v` forms new tetrahedron in place of removed ones
+        keys_.clear();
+        size_t reused = 0;
+        for (const Facet& f: facets_) {
+            Index nt = reused < conflict_.size() ? conflict_[reused++] : NewTetrahedron();
+            std::copy(f.v, f.v + 4, vertices_.begin() + 4 * nt);
+            neighbours_[4 * nt + f.k] = f.outer;
+            neighbours_[4 * f.outer + f.back] = nt;
+            marks_[nt] = 0;
+
+            for (size_t j = 0; j < 4; ++j) {
+                if (j == f.k)
+                    continue;
+
+                // face opposite to `j` contains `v` and the edge (u, w)
+                FaceKey key;
+                size_t a = (j + 1) % 4 == f.k ? (j + 2) % 4 : (j + 1) % 4;
+                size_t b = 6 - j - f.k - a;
+                key.u = std::min(f.v[a], f.v[b]);
+                key.v = std::max(f.v[a], f.v[b]);
+                key.t = nt;
+                key.k = j;
+                keys_.push_back(key);
+            }
+        }
+
+        for (size_t i = reused; i < conflict_.size(); ++i) {
+            std::fill(vertices_.begin() + 4 * conflict_[i], vertices_.begin() + 4 * conflict_[i] + 4, NONE);
+            free_.push_back(conflict_[i]);
+        }
+
+        std::sort(keys_.begin(), keys_.end());
+        for (size_t i = 0; i + 1 < keys_.size(); i += 2) {
+            assert(keys_[i].u == keys_[i + 1].u && keys_[i].v == keys_[i + 1].v);
+            neighbours_[4 * keys_[i].t + keys_[i].k] = keys_[i + 1].t;
+            neighbours_[4 * keys_[i + 1].t + keys_[i + 1].k] = keys_[i].t;
+        }
+
+        hint_ = keys_.empty() ? 0 : keys_[0].t;
+        return v;
+    }
+
+    // drops removed tetrahedra
+    void Compact() {
+        std::vector<Index> remap(TetrahedraCount(), NONE);
+        Index count = 0;
+        for (size_t t = 0; t < TetrahedraCount(); ++t) {
+            if (!IsRemoved(t))
+                remap[t] = count++;
+        }
+
+        for (size_t t = 0; t < TetrahedraCount(); ++t) {
+            if (remap[t] == NONE)
+                continue;
+            for (size_t k = 0; k < 4; ++k) {
+                vertices_[4 * remap[t] + k] = vertices_[4 * t + k];
+                neighbours_[4 * remap[t] + k] = remap[neighbours_[4 * t + k]];
+            }
+        }
+
+        vertices_.resize(4 * count);
+        neighbours_.resize(4 * count);
+        marks_.assign(count, 0);
+        free_.clear();
+        stamp_ = 0;
+        hint_ = 0;
+    }
+
+private:
+    std::vector<Pnt> points_;
+    std::vector<Index> vertices_;
+    std::vector<Index> neighbours_;
+    std::vector<unsigned> marks_;
+    std::vector<Index> free_;
+    Index hint_;
+    unsigned stamp_;
+    unsigned long long seed_;
+
+    // scratch buffers of insertion
+    std::vector<Index> conflict_;
+    std::vector<Facet> facets_;
+    std::vector<FaceKey> keys_;
+};
+
+template<typename Tp, typename Index>
+const Index Delaunay3<Tp, Index>::NONE;
+
+template<typename Tp, typename Index>
+const Index Delaunay3<Tp, Index>::INFINITE;
+
+template<typename Tp, typename Index>
+std::ostream& operator << (std::ostream& out, const Delaunay3<Tp, Index>& delaunay) {
+    using std::endl;
+
+    std::vector<Index> tetrahedra = delaunay.FiniteTetrahedra();
+    out << "[TETRAHEDRA]" << endl;
+    out << tetrahedra.size() / 4 << endl;
+    for (size_t i = 0; i < tetrahedra.size(); i += 4) {
+        out << tetrahedra[i] + 1 << " " << tetrahedra[i + 1] + 1 << " "
+            << tetrahedra[i + 2] + 1 << " " << tetrahedra[i + 3] + 1 << endl;
+    }
+    return out;
+}
+
+} // namespace geometry
+
+#endif // DELAUNAY3_H
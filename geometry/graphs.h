@@ -0,0 +1,176 @@
+#ifndef GRAPHS_H
+#define GRAPHS_H
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include "point.h"
+#include "predicates.h"
+#include "triangle_mesh.h"
+#include "delaunay.h"
+#include "parallel.h"
+
+namespace geometry {
+
+// union-find with path halving and union by size
+class DisjointSets {
+public:
+    explicit DisjointSets(size_t count)
+        : parent_(count)
+        , size_(count, 1)
+    {
+        std::iota(parent_.begin(), parent_.end(), 0);
+    }
+
+    size_t Find(size_t x) {
+        while (parent_[x] != x) {
+            parent_[x] = parent_[parent_[x]];
+            x = parent_[x];
+        }
+        return x;
+    }
+
+    // returns false if `x` and `y` are already in the same set
+    bool Unite(size_t x, size_t y) {
+        x = Find(x);
+        y = Find(y);
+        if (x == y)
+            return false;
+
+        if (size_[x] < size_[y])
+            std::swap(x, y);
+        parent_[y] = x;
+        size_[x] += size_[y];
+        return true;
+    }
+
+private:
+    std::vector<size_t> parent_;
+    std::vector<size_t> size_;
+};
+
+template<typename Weight>
+struct WeightedEdge {
+    WeightedEdge() {}
+
+    WeightedEdge(Weight w, size_t u, size_t v)
+        : w(w)
+        , u(u)
+        , v(v)
+    {}
+
+    bool operator<(const WeightedEdge& oth) const {
+        return w < oth.w;
+    }
+
+    Weight w;
+    size_t u;
+    size_t v;
+};
+
+// edges of Delaunay triangulation of `points` weighted by `Distance2`
+// every duplicate point is connected to its representative by zero-length edge,
+// collinear points are connected in sorted order
+template<typename Tp>
+std::vector<WeightedEdge<typename DistanceType<Tp>::type>>
+DelaunayEdges(const std::vector<Point<Tp, 2>>& points) {
+    typedef typename DistanceType<Tp>::type Weight;
+    typedef WeightedEdge<Weight> Edge;
+
+    std::vector<Edge> edges;
+    if (points.size() < 2)
+        return edges;
+
+    Delaunay<Tp, size_t> delaunay(points);
+    const TriangleMesh<size_t>& mesh = delaunay.GetMesh();
+
+    if (mesh.TrianglesCount() == 0) {
+        std::vector<size_t> order(points.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&points] (size_t a, size_t b) {
+            return points[a] < points[b];
+        });
+
+        for (size_t i = 0; i + 1 < order.size(); ++i) {
+            const Point<Tp, 2>& a = points[order[i]];
+            const Point<Tp, 2>& b = points[order[i + 1]];
+            edges.push_back(Edge(a.template Distance2<Weight>(b), order[i], order[i + 1]));
+        }
+        return edges;
+    }
+
+    edges.reserve(3 * points.size());
+    const std::vector<size_t>& twins = mesh.Twins();
+    for (size_t h = 0; h < twins.size(); ++h) {
+        if (twins[h] != TriangleMesh<size_t>::NONE && twins[h] < h)
+            continue;
+
+        size_t u = mesh.Origin(h);
+        size_t v = mesh.Target(h);
+        edges.push_back(Edge(points[u].template Distance2<Weight>(points[v]), u, v));
+    }
+
+    for (size_t v = 0; v < points.size(); ++v) {
+        if (mesh.VertexEdge(v) != TriangleMesh<size_t>::NONE)
+            continue;
+
+        size_t h;
+        if (delaunay.Locate(points[v], h) == Delaunay<Tp, size_t>::ON_VERTEX)
+            edges.push_back(Edge(Weight(0), mesh.Origin(h), v));
+    }
+
+    return edges;
+}
+
+// Kruskal's algorithm over Delaunay edges, which contain the Euclidean MST
+// returns n - 1 edges as pairs of indices of `points`
+template<typename Tp>
+std::vector<std::pair<size_t, size_t>> EuclideanMST(const std::vector<Point<Tp, 2>>& points,
+                                                    size_t threads = 1)
+{
+    typedef typename DistanceType<Tp>::type Weight;
+
+    std::vector<WeightedEdge<Weight>> edges = DelaunayEdges(points);
+    ParallelSort(edges.begin(), edges.end(), std::less<WeightedEdge<Weight>>(), threads);
+
+    std::vector<std::pair<size_t, size_t>> res;
+    res.reserve(points.size());
+
+    DisjointSets sets(points.size());
+    for (const auto& e: edges) {
+        if (sets.Unite(e.u, e.v)) {
+            res.push_back(std::make_pair(e.u, e.v));
+            if (res.size() + 1 == points.size())
+                break;
+        }
+    }
+
+    return res;
+}
+
+// returns index of the nearest other point for every point, -1 for a single point
+// nearest neighbour is always connected to the point by Delaunay edge
+template<typename Tp>
+std::vector<size_t> NearestNeighbourGraph(const std::vector<Point<Tp, 2>>& points) {
+    typedef typename DistanceType<Tp>::type Weight;
+
+    std::vector<size_t> res(points.size(), static_cast<size_t>(-1));
+    std::vector<Weight> best(points.size());
+
+    auto relax = [&res, &best] (size_t u, size_t v, Weight w) {
+        if (res[u] == static_cast<size_t>(-1) || w < best[u]) {
+            res[u] = v;
+            best[u] = w;
+        }
+    };
+
+    for (const auto& e: DelaunayEdges(points)) {
+        relax(e.u, e.v, e.w);
+        relax(e.v, e.u, e.w);
+    }
+
+    return res;
+}
+
+} // namespace geometry
+
+#endif // GRAPHS_H
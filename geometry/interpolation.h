@@ -0,0 +1,267 @@
+#ifndef INTERPOLATION_H
+#define INTERPOLATION_H
+#include <vector>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include "point.h"
+#include "predicates.h"
+#include "circle.h"
+#include "triangle_mesh.h"
+#include "delaunay.h"
+#include "parallel.h"
+
+namespace geometry {
+
+enum InterpolationType : int {
+    LINEAR, NATURAL_NEIGHBOUR
+};
+
+// interpolates values given at vertices of Delaunay triangulation
+// queries walk from a triangle given by the caller, so close queries are cheap
+// if every caller keeps its own `hint`, queries may run concurrently
+// `mesh` and `values` must outlive the interpolator
+template<typename Tp, typename Index = uint32_t>
+class Interpolator {
+public:
+    typedef Point<double, 2> Pnt;
+    static const Index NONE = TriangleMesh<Index>::NONE;
+
+public:
+    Interpolator(const Delaunay<Tp, Index>& mesh, const std::vector<double>& values)
+        : mesh_(mesh)
+        , topology_(mesh.GetMesh())
+        , values_(values)
+    {
+        assert(values_.size() == mesh_.PointsCount());
+    }
+
+    // returns triangle containing `p` or NONE if `p` is out of the hull
+    // `hint` is a triangle to start from, it is set to the last visited triangle
+    Index Locate(const Pnt& p, Index& hint) const {
+        size_t count = topology_.TrianglesCount();
+        if (count == 0)
+            return NONE;
+
+        Index t = hint < count ? hint : 0;
+        Index came = NONE;
+        size_t max_steps = 4 * count + 16;
+
+        // visibility walk, the first edge tried changes with every step to avoid cycles
+        for (size_t steps = 0; steps < max_steps; ++steps) {
+            bool moved = false;
+            for (Index k = 0; k < 3 && !moved; ++k) {
+                Index e = 3 * t + (k + steps) % 3;
+                if (e == came)
+                    continue;
+
+                if (Orientation(From(e), To(e), p) < 0) {
+                    hint = t;
+                    if (topology_.Twin(e) == NONE)
+                        return NONE;
+                    came = topology_.Twin(e);
+                    t = came / 3;
+                    moved = true;
+                }
+            }
+
+            if (!moved) {
+                hint = t;
+                return t;
+            }
+        }
+
+        for (t = 0; t < count; ++t) {
+            bool inside = true;
+            for (Index e = 3 * t; e < 3 * t + 3 && inside; ++e)
+                inside = Orientation(From(e), To(e), p) >= 0;
+
+            if (inside) {
+                hint = t;
+                return t;
+            }
+        }
+        return NONE;
+    }
+
+    // barycentric interpolation in the triangle containing `p`
+    // returns false if `p` is out of the hull
+    bool Linear(const Pnt& p, double& value, Index& hint) const {
+        Index t = Locate(p, hint);
+        if (t == NONE)
+            return false;
+
+        value = Linear(t, p);
+        return true;
+    }
+
+    // Sibson interpolation: weight of a natural neighbour is the area, which the Voronoi cell
+    // of `p` would take from its cell; the cells are found from the triangles, whose
+    // circumcircles contain `p` (Bowyer-Watson cavity)
+    // points on the hull are interpolated linearly, returns false if `p` is out of the hull
+    bool NaturalNeighbour(const Pnt& p, double& value, Index& hint) const {
+        Index t = Locate(p, hint);
+        if (t == NONE)
+            return false;
+
+        Scratch& scratch = LocalScratch();
+        std::vector<Index>& cavity = scratch.cavity;
+        std::vector<Index>& boundary = scratch.boundary;
+        std::vector<char>& in_cavity = scratch.in_cavity;
+        in_cavity.resize(topology_.TrianglesCount(), 0);
+
+        for (Index e = 3 * t; e < 3 * t + 3; ++e) {
+            if (From(e) == p) {
+                value = values_[topology_.Origin(e)];
+                return true;
+            }
+            if (topology_.Twin(e) == NONE && Orientation(From(e), To(e), p) == 0) {
+                value = Linear(t, p);
+                return true;
+            }
+        }
+
+        cavity.assign(1, t);
+        in_cavity[t] = 1;
+        boundary.clear();
+        for (size_t i = 0; i < cavity.size(); ++i) {
+            for (Index e = 3 * cavity[i]; e < 3 * cavity[i] + 3; ++e) {
+                Index twin = topology_.Twin(e);
+                if (twin != NONE && in_cavity[twin / 3])
+                    continue;
+
+                if (twin != NONE && InCircle(From(twin), To(twin), Far(twin), p) > 0) {
+                    in_cavity[twin / 3] = 1;
+                    cavity.push_back(twin / 3);
+                } else {
+                    boundary.push_back(e);
+                }
+            }
+        }
+
+        // boundary edge `e` (u, v) is followed by the next boundary edge from v
+        // the part of the new cell taken from v is bounded by the new Voronoi vertices
+        // of (p, u, v), (p, v, w) and the old ones of cavity triangles around v
+        double sum = 0;
+        double weighted = 0;
+        for (Index e: boundary) {
+            Index v = topology_.Target(e);
+            Pnt first = Circumcenter(p, From(e), To(e));
+            Pnt prev = first;
+            double area = 0;
+
+            Index h = TriangleMesh<Index>::Next(e);
+            for (;;) {
+                Pnt center = Circumcenter(From(h), To(h), Far(h));
+                area += Area(p, prev, center);
+                prev = center;
+
+                Index twin = topology_.Twin(h);
+                if (twin == NONE || !in_cavity[twin / 3])
+                    break;
+                h = TriangleMesh<Index>::Next(twin);
+            }
+
+            Pnt last = Circumcenter(p, From(h), To(h));
+            area += Area(p, prev, last) + Area(p, last, first);
+            area = std::abs(area) / 2;
+
+            sum += area;
+            weighted += area * values_[v];
+        }
+
+        for (Index c: cavity)
+            in_cavity[c] = 0;
+
+        value = sum > 0 ? weighted / sum : Linear(t, p);
+        return true;
+    }
+
+    // interpolates values at nodes of `rows` x `cols` grid into `res`, the node (i, j)
+    // is origin + (j * step_x, i * step_y), nodes out of the hull get `nodata`
+    // rows are taken by threads in blocks, the walk goes on from the previous node
+    void Rasterize(const Pnt& origin, double step_x, double step_y, size_t rows, size_t cols,
+                   std::vector<double>& res, InterpolationType type = LINEAR,
+                   double nodata = NAN, size_t threads = 1) const
+    {
+        res.assign(rows * cols, nodata);
+        ParallelBlocks(rows, threads, 16, [&] (size_t, size_t begin, size_t end) {
+            Index hint = 0;
+            Index row_hint = 0;
+            for (size_t i = begin; i < end; ++i) {
+                // the first node of the row is near the first node of the previous one
+                hint = row_hint;
+                for (size_t j = 0; j < cols; ++j) {
+                    Pnt p(origin.x() + j * step_x, origin.y() + i * step_y);
+                    double& value = res[i * cols + j];
+                    if (type == LINEAR)
+                        Linear(p, value, hint);
+                    else
+                        NaturalNeighbour(p, value, hint);
+                    if (j == 0)
+                        row_hint = hint;
+                }
+            }
+        });
+    }
+
+private:
+    // per-thread buffers of natural neighbour queries
+    struct Scratch {
+        std::vector<Index> cavity;
+        std::vector<Index> boundary;
+        std::vector<char> in_cavity;
+    };
+
+    static Scratch& LocalScratch() {
+        static thread_local Scratch scratch;
+        return scratch;
+    }
+
+    Pnt Vertex(Index v) const {
+        const Point<Tp, 2>& p = mesh_.GetPoint(v);
+        return Pnt(static_cast<double>(p.x()), static_cast<double>(p.y()));
+    }
+
+    Pnt From(Index h) const {
+        return Vertex(topology_.Origin(h));
+    }
+
+    Pnt To(Index h) const {
+        return Vertex(topology_.Target(h));
+    }
+
+    // vertex of the triangle of `h` opposite to it
+    Pnt Far(Index h) const {
+        return Vertex(topology_.Origin(TriangleMesh<Index>::Prev(h)));
+    }
+
+    double Linear(Index t, const Pnt& p) const {
+        Pnt a = From(3 * t);
+        Pnt b = From(3 * t + 1);
+        Pnt c = From(3 * t + 2);
+
+        double det = Area(a, b, c);
+        double wa = Area(p, b, c) / det;
+        double wb = Area(a, p, c) / det;
+        return values_[topology_.Vertex(t, 0)] * wa
+             + values_[topology_.Vertex(t, 1)] * wb
+             + values_[topology_.Vertex(t, 2)] * (1 - wa - wb);
+    }
+
+    static double Area(const Pnt& a, const Pnt& b, const Pnt& c) {
+        return (b.x() - a.x()) * (c.y() - a.y()) - (b.y() - a.y()) * (c.x() - a.x());
+    }
+
+private:
+    const Delaunay<Tp, Index>& mesh_;
+    const TriangleMesh<Index>& topology_;
+    const std::vector<double>& values_;
+};
+
+template<typename Tp, typename Index>
+const Index Interpolator<Tp, Index>::NONE;
+
+} // namespace geometry
+
+#endif // INTERPOLATION_H
@@ -0,0 +1,304 @@
+#ifndef KD_TREE_H
+#define KD_TREE_H
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <cassert>
+#include <limits>
+#include "point.h"
+#include "predicates.h"
+#include "parallel.h"
+
+namespace geometry {
+
+// implicit k-d tree over `Point<Tp, dim>`
+//
+// the tree is complete: node `i` has children 2i + 1 and 2i + 2, every leaf is on depth `depth_`
+// and holds a bucket of at most `leaf_size` points; points are stored in the leaf order,
+// so a bucket is a contiguous range and ranges of nodes are computed on the fly
+// all distances are `Distance2`, so radius queries take squared radius
+template<typename Tp, size_t dim = 2>
+class KdTree {
+public:
+    typedef Point<Tp, dim> Pnt;
+    typedef typename DistanceType<Tp>::type Dist;
+
+    static const size_t NONE = static_cast<size_t>(-1);
+
+public:
+    explicit KdTree(const std::vector<Pnt>& points, size_t leaf_size = 16, size_t threads = 1)
+        : depth_(0)
+    {
+        assert(leaf_size > 0);
+        while ((points.size() >> depth_) > leaf_size)
+            ++depth_;
+
+        ids_.resize(points.size());
+        for (size_t i = 0; i < ids_.size(); ++i)
+            ids_[i] = i;
+
+        size_t internal = (size_t(1) << depth_) - 1;
+        split_dim_.resize(internal);
+        split_value_.resize(internal);
+
+        size_t parallel_depth = 0;
+        while ((size_t(1) << parallel_depth) < ThreadsCount(threads, points.size()))
+            ++parallel_depth;
+
+        Build(points, 0, 0, points.size(), 0, parallel_depth);
+
+        points_.reserve(points.size());
+        for (size_t id: ids_)
+            points_.push_back(points[id]);
+    }
+
+    size_t Size() const {
+        return points_.size();
+    }
+
+    // returns index of the nearest point, NONE for the empty tree
+    size_t Nearest(const Pnt& p) const {
+        size_t best = NONE;
+        Dist best_dist = std::numeric_limits<Dist>::max();
+        NearestSearch(0, 0, points_.size(), 0, p, best, best_dist);
+        return best;
+    }
+
+    // writes indices of `k` nearest points ordered by distance into `res`
+    void Nearest(const Pnt& p, size_t k, std::vector<size_t>& res) const {
+        std::vector<std::pair<Dist, size_t>> heap;
+        heap.reserve(k + 1);
+        if (k > 0)
+            KNearestSearch(0, 0, points_.size(), 0, p, k, heap);
+
+        std::sort_heap(heap.begin(), heap.end());
+        res.clear();
+        for (const auto& item: heap)
+            res.push_back(item.second);
+    }
+
+    // appends indices of points with `Distance2` to `p` <= `radius2` to `res`
+    void Radius(const Pnt& p, Dist radius2, std::vector<size_t>& res) const {
+        RadiusSearch(0, 0, points_.size(), 0, p, radius2, res);
+    }
+
+    // appends indices of points inside box [`lo`, `hi`] to `res`
+    void Box(const Pnt& lo, const Pnt& hi, std::vector<size_t>& res) const {
+        BoxSearch(0, 0, points_.size(), 0, lo, hi, res);
+    }
+
+    // batch version of `Nearest`, res[i] is the nearest point of queries[i]
+    std::vector<size_t> Nearest(const std::vector<Pnt>& queries, size_t threads) const {
+        std::vector<size_t> res(queries.size());
+        ParallelFor(queries.size(), threads, [&] (size_t i) {
+            res[i] = Nearest(queries[i]);
+        });
+        return res;
+    }
+
+    // batch version of k-NN, neighbours of queries[i] are res[i * k], ..., res[i * k + k - 1]
+    // missing neighbours (less than `k` points in the tree) are NONE
+    void Nearest(const std::vector<Pnt>& queries, size_t k,
+                 std::vector<size_t>& res, size_t threads) const
+    {
+        res.assign(queries.size() * k, NONE);
+        ParallelChunks(queries.size(), threads, [&] (size_t, size_t begin, size_t end) {
+            std::vector<size_t> cur;
+            for (size_t i = begin; i < end; ++i) {
+                Nearest(queries[i], k, cur);
+                std::copy(cur.begin(), cur.end(), res.begin() + i * k);
+            }
+        });
+    }
+
+    // batch version of `Radius`, result of queries[i] is res[offsets[i]], ..., res[offsets[i + 1] - 1]
+    void Radius(const std::vector<Pnt>& queries, Dist radius2, std::vector<size_t>& res,
+                std::vector<size_t>& offsets, size_t threads) const
+    {
+        size_t chunks = ThreadsCount(threads, queries.size());
+        std::vector<std::vector<size_t>> chunk_res(chunks);
+        offsets.assign(queries.size() + 1, 0);
+
+        ParallelChunks(queries.size(), chunks, [&] (size_t chunk, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                size_t before = chunk_res[chunk].size();
+                Radius(queries[i], radius2, chunk_res[chunk]);
+                offsets[i + 1] = chunk_res[chunk].size() - before;
+            }
+        });
+
+        for (size_t i = 0; i < queries.size(); ++i)
+            offsets[i + 1] += offsets[i];
+
+        res.clear();
+        res.reserve(offsets.back());
+        for (const auto& chunk: chunk_res)
+            res.insert(res.end(), chunk.begin(), chunk.end());
+    }
+
+private:
+    bool IsLeaf(size_t depth) const {
+        return depth == depth_;
+    }
+
+    // reorders ids_ in [begin, end) by the tree, points are gathered in the leaf order afterwards
+    void Build(const std::vector<Pnt>& points, size_t node, size_t begin, size_t end,
+               size_t depth, size_t parallel_depth)
+    {
+        if (IsLeaf(depth))
+            return;
+
+        // split by the dimension of the largest spread
+        size_t best_dim = 0;
+        Dist best_spread = -1;
+        for (size_t d = 0; d < dim; ++d) {
+            Tp lo = points[ids_[begin]].Get(d);
+            Tp hi = lo;
+            for (size_t i = begin + 1; i < end; ++i) {
+                lo = std::min(lo, points[ids_[i]].Get(d));
+                hi = std::max(hi, points[ids_[i]].Get(d));
+            }
+            if ((Dist) hi - lo > best_spread) {
+                best_spread = (Dist) hi - lo;
+                best_dim = d;
+            }
+        }
+
+        size_t mid = begin + (end - begin) / 2;
+        std::nth_element(ids_.begin() + begin, ids_.begin() + mid, ids_.begin() + end,
+            [&points, best_dim] (size_t a, size_t b) {
+                return points[a].Get(best_dim) < points[b].Get(best_dim);
+            });
+        split_dim_[node] = static_cast<unsigned char>(best_dim);
+        split_value_[node] = points[ids_[mid]].Get(best_dim);
+
+        if (depth < parallel_depth) {
+            std::thread left([=, &points] {
+                Build(points, 2 * node + 1, begin, mid, depth + 1, parallel_depth);
+            });
+            Build(points, 2 * node + 2, mid, end, depth + 1, parallel_depth);
+            left.join();
+        } else {
+            Build(points, 2 * node + 1, begin, mid, depth + 1, parallel_depth);
+            Build(points, 2 * node + 2, mid, end, depth + 1, parallel_depth);
+        }
+    }
+
+    void NearestSearch(size_t node, size_t begin, size_t end, size_t depth,
+                       const Pnt& p, size_t& best, Dist& best_dist) const
+    {
+        if (IsLeaf(depth)) {
+            for (size_t i = begin; i < end; ++i) {
+                Dist dist = p.template Distance2<Dist>(points_[i]);
+                if (dist < best_dist) {
+                    best_dist = dist;
+                    best = ids_[i];
+                }
+            }
+            return;
+        }
+
+        size_t mid = begin + (end - begin) / 2;
+        Dist diff = (Dist) p.Get(split_dim_[node]) - split_value_[node];
+        if (diff < 0) {
+            NearestSearch(2 * node + 1, begin, mid, depth + 1, p, best, best_dist);
+            if (diff * diff < best_dist)
+                NearestSearch(2 * node + 2, mid, end, depth + 1, p, best, best_dist);
+        } else {
+            NearestSearch(2 * node + 2, mid, end, depth + 1, p, best, best_dist);
+            if (diff * diff < best_dist)
+                NearestSearch(2 * node + 1, begin, mid, depth + 1, p, best, best_dist);
+        }
+    }
+
+    // `heap` is a max-heap of at most `k` the nearest points found so far
+    void KNearestSearch(size_t node, size_t begin, size_t end, size_t depth, const Pnt& p,
+                        size_t k, std::vector<std::pair<Dist, size_t>>& heap) const
+    {
+        if (IsLeaf(depth)) {
+            for (size_t i = begin; i < end; ++i) {
+                Dist dist = p.template Distance2<Dist>(points_[i]);
+                if (heap.size() < k || dist < heap.front().first) {
+                    heap.push_back(std::make_pair(dist, ids_[i]));
+                    std::push_heap(heap.begin(), heap.end());
+                    if (heap.size() > k) {
+                        std::pop_heap(heap.begin(), heap.end());
+                        heap.pop_back();
+                    }
+                }
+            }
+            return;
+        }
+
+        size_t mid = begin + (end - begin) / 2;
+        Dist diff = (Dist) p.Get(split_dim_[node]) - split_value_[node];
+        size_t near = diff < 0 ? 1 : 2;
+
+        if (near == 1)
+            KNearestSearch(2 * node + 1, begin, mid, depth + 1, p, k, heap);
+        else
+            KNearestSearch(2 * node + 2, mid, end, depth + 1, p, k, heap);
+
+        if (heap.size() < k || diff * diff < heap.front().first) {
+            if (near == 1)
+                KNearestSearch(2 * node + 2, mid, end, depth + 1, p, k, heap);
+            else
+                KNearestSearch(2 * node + 1, begin, mid, depth + 1, p, k, heap);
+        }
+    }
+
+    void RadiusSearch(size_t node, size_t begin, size_t end, size_t depth,
+                      const Pnt& p, Dist radius2, std::vector<size_t>& res) const
+    {
+        if (IsLeaf(depth)) {
+            for (size_t i = begin; i < end; ++i) {
+                if (p.template Distance2<Dist>(points_[i]) <= radius2)
+                    res.push_back(ids_[i]);
+            }
+            return;
+        }
+
+        size_t mid = begin + (end - begin) / 2;
+        Dist diff = (Dist) p.Get(split_dim_[node]) - split_value_[node];
+        if (diff <= 0 || diff * diff <= radius2)
+            RadiusSearch(2 * node + 1, begin, mid, depth + 1, p, radius2, res);
+        if (diff >= 0 || diff * diff <= radius2)
+            RadiusSearch(2 * node + 2, mid, end, depth + 1, p, radius2, res);
+    }
+
+    void BoxSearch(size_t node, size_t begin, size_t end, size_t depth,
+                   const Pnt& lo, const Pnt& hi, std::vector<size_t>& res) const
+    {
+        if (IsLeaf(depth)) {
+            for (size_t i = begin; i < end; ++i) {
+                bool inside = true;
+                for (size_t d = 0; d < dim && inside; ++d)
+                    inside = lo.Get(d) <= points_[i].Get(d) && points_[i].Get(d) <= hi.Get(d);
+                if (inside)
+                    res.push_back(ids_[i]);
+            }
+            return;
+        }
+
+        size_t mid = begin + (end - begin) / 2;
+        size_t d = split_dim_[node];
+        if (lo.Get(d) <= split_value_[node])
+            BoxSearch(2 * node + 1, begin, mid, depth + 1, lo, hi, res);
+        if (hi.Get(d) >= split_value_[node])
+            BoxSearch(2 * node + 2, mid, end, depth + 1, lo, hi, res);
+    }
+
+private:
+    size_t depth_;
+    std::vector<Pnt> points_;
+    std::vector<size_t> ids_;
+    std::vector<unsigned char> split_dim_;
+    std::vector<Tp> split_value_;
+};
+
+template<typename Tp, size_t dim>
+const size_t KdTree<Tp, dim>::NONE;
+
+} // namespace geometry
+
+#endif // KD_TREE_H
@@ -0,0 +1,91 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <atomic>
+
+namespace geometry {
+
+// returns count of threads to use, 0 means all hardware threads
+inline size_t ThreadsCount(size_t threads, size_t count) {
+    if (threads == 0)
+        threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+    return std::max<size_t>(std::min(threads, count), 1);
+}
+
+// splits [0, count) into `ThreadsCount(threads, count)` consecutive chunks
+// and calls `func(chunk, begin, end)` for every chunk in its own thread
+template<typename Func>
+void ParallelChunks(size_t count, size_t threads, Func func) {
+    threads = ThreadsCount(threads, count);
+    size_t chunk = (count + threads - 1) / threads;
+
+    if (threads == 1) {
+        func(0, 0, count);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        size_t begin = std::min(count, i * chunk);
+        size_t end = std::min(count, begin + chunk);
+        workers.push_back(std::thread(func, i, begin, end));
+    }
+
+    for (auto& worker: workers)
+        worker.join();
+}
+
+// calls `func(i)` for every i in [0, count)
+template<typename Func>
+void ParallelFor(size_t count, size_t threads, Func func) {
+    ParallelChunks(count, threads, [&func] (size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            func(i);
+    });
+}
+
+// splits [0, count) into blocks of `grain` indices, which are taken by threads one by one,
+// so threads finishing cheap blocks earlier take more of them
+// calls `func(thread, begin, end)` for every block
+template<typename Func>
+void ParallelBlocks(size_t count, size_t threads, size_t grain, Func func) {
+    grain = std::max<size_t>(grain, 1);
+    size_t blocks = (count + grain - 1) / grain;
+    std::atomic<size_t> next(0);
+
+    ParallelChunks(blocks, threads, [&] (size_t thread, size_t, size_t) {
+        for (size_t block = next++; block < blocks; block = next++)
+            func(thread, block * grain, std::min(count, (block + 1) * grain));
+    });
+}
+
+// sorts chunks in parallel, then merges neighbour chunks level by level
+template<typename RandomIt, typename Compare>
+void ParallelSort(RandomIt first, RandomIt last, Compare comp, size_t threads = 1) {
+    size_t count = static_cast<size_t>(last - first);
+    threads = ThreadsCount(threads, count / 1024);
+
+    std::vector<size_t> bounds(threads + 1, count);
+    ParallelChunks(count, threads, [&] (size_t chunk, size_t begin, size_t end) {
+        bounds[chunk] = begin;
+        std::sort(first + begin, first + end, comp);
+    });
+
+    for (size_t step = 1; step < threads; step *= 2) {
+        size_t merges = (threads + 2 * step - 1) / (2 * step);
+        ParallelFor(merges, merges, [&] (size_t i) {
+            size_t left = 2 * i * step;
+            size_t mid = std::min(left + step, threads);
+            size_t right = std::min(left + 2 * step, threads);
+            std::inplace_merge(first + bounds[left], first + bounds[mid], first + bounds[right], comp);
+        });
+    }
+}
+
+} // namespace geometry
+
+#endif // PARALLEL_H
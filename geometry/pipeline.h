@@ -0,0 +1,141 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <cassert>
+
+namespace geometry {
+
+// blocking queue of at most `capacity` items
+// producers call `Close` when done, then `Pop` fails as soon as the queue is empty
+template<typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity)
+        : capacity_(capacity)
+        , closed_(false)
+    {
+        assert(capacity_ > 0);
+    }
+
+    void Push(T value) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return items_.size() < capacity_; });
+        assert(!closed_);
+        items_.push_back(std::move(value));
+        not_empty_.notify_one();
+    }
+
+    bool Pop(T& value) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return !items_.empty() || closed_; });
+        if (items_.empty())
+            return false;
+
+        value = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    void Close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_empty_.notify_all();
+    }
+
+private:
+    std::deque<T> items_;
+    size_t capacity_;
+    bool closed_;
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+};
+
+// chain of stages, each running in its own thread
+// stages pass items through queues of `depth` items, so while one stage works on item k
+// the previous one prepares item k + 1, and at most `depth` items wait between two stages
+// order of items is kept; a stage, which needs more threads, may use them on its item
+//
+//     Pipeline pipeline(2);
+//     auto chunks = pipeline.Source<Chunk>([&] (Chunk& chunk) { return Read(in, chunk); });
+//     auto meshes = pipeline.Stage(chunks, [] (Chunk chunk) { return Triangulate(chunk); });
+//     pipeline.Sink(meshes, [&] (Mesh mesh) { out << mesh; });
+//     pipeline.Wait();
+class Pipeline {
+public:
+    template<typename T>
+    using Channel = std::shared_ptr<BoundedQueue<T>>;
+
+public:
+    explicit Pipeline(size_t depth = 2)
+        : depth_(depth)
+    {}
+
+    ~Pipeline() {
+        Wait();
+    }
+
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    // `func(item)` fills the next item, returns false when there are no more items
+    template<typename T, typename Func>
+    Channel<T> Source(Func func) {
+        Channel<T> output = std::make_shared<BoundedQueue<T>>(depth_);
+        workers_.push_back(std::thread([output, func] () mutable {
+            T item;
+            while (func(item))
+                output->Push(std::move(item));
+            output->Close();
+        }));
+        return output;
+    }
+
+    // passes `func(item)` of every input item to the next stage
+    template<typename T, typename Func>
+    Channel<typename std::result_of<Func(T)>::type> Stage(const Channel<T>& input, Func func) {
+        typedef typename std::result_of<Func(T)>::type U;
+
+        Channel<U> output = std::make_shared<BoundedQueue<U>>(depth_);
+        workers_.push_back(std::thread([input, output, func] () mutable {
+            T item;
+            while (input->Pop(item))
+                output->Push(func(std::move(item)));
+            output->Close();
+        }));
+        return output;
+    }
+
+    // calls `func(item)` for every input item
+    template<typename T, typename Func>
+    void Sink(const Channel<T>& input, Func func) {
+        workers_.push_back(std::thread([input, func] () mutable {
+            T item;
+            while (input->Pop(item))
+                func(std::move(item));
+        }));
+    }
+
+    // waits until every stage is done
+    void Wait() {
+        for (auto& worker: workers_)
+            worker.join();
+        workers_.clear();
+    }
+
+private:
+    size_t depth_;
+    std::vector<std::thread> workers_;
+};
+
+} // namespace geometry
+
+#endif // PIPELINE_H
@@ -5,7 +5,7 @@
 #include <tuple>
 #include <functional>
 #include <cassert>
-#include <string.h>
+#include <type_traits>
 #include <cmath>
 #include <limits>
 #include <cstdlib>
@@ -21,25 +21,22 @@ class Segment;
 template<typename Tp, size_t dim = 2> 
 class Point {
 public:
-    const size_t sz = dim;
+    static constexpr size_t dimension = dim;
     typedef Point<Tp, dim> Pnt;
     typedef Vector<Tp, dim> Vec;
 
 public: 
-    Point() {
-        memset(coordinates_, 0, sizeof(coordinates_));
-    }
-
-    template<class...CoordinateType>
-    Point(CoordinateType ... coordinates) {
-        static_assert(sizeof...(CoordinateType) == dim, 
-                "count of coordinates must be equal to count of dimensions of Point");
-        Init(0, coordinates...);
-    }
-
-    Point(const Point<Tp, dim>& oth) {
-        *this = oth;
-    }
+    // the point is trivially copyable, so vectors of points are copied by `memcpy`
+    constexpr Point()
+        : coordinates_()
+    {}
+
+    template<class...CoordinateType, typename = typename
+        std::enable_if<sizeof...(CoordinateType) == dim>::type
+    >
+    constexpr Point(CoordinateType ... coordinates)
+        : coordinates_{static_cast<Tp>(coordinates)...}
+    {}
 
     template <typename U>
     Point(const Point<U, dim>& oth) {
@@ -47,7 +44,7 @@ public:
     }
 
     Point(const Vector<Tp, dim>& vec) {
-        std::copy(vec.coordinates_, vec.coordinates_ + sz, coordinates_);
+        std::copy(vec.coordinates_, vec.coordinates_ + dim, coordinates_);
     }
 
     double Distance(const Segment<Tp, dim>& segment) const {
@@ -55,7 +52,7 @@ public:
         const Pnt& p2 = segment.p2_;
 
         double min_dist = std::min(Distance(p1), Distance(p2));
-        Vec norm = segment.v_.GetNormal();
+        Vec norm = segment.Direction().GetNormal();
 
         if (norm.Rotate(Vec(*this, p1)) * norm.Rotate(Vec(*this, p2)) < 0) {
             min_dist = std::min(min_dist, std::abs(
@@ -89,20 +86,19 @@ public:
         return sum;
     }
 
-    Tp Get(size_t id) const {
-        assert(id < dim);
-        return coordinates_[id];
+    constexpr Tp Get(size_t id) const {
+        return assert(id < dim), coordinates_[id];
     }
 
-    Tp x() const {
+    constexpr Tp x() const {
         return Get(0);
     }
 
-    Tp y() const {
+    constexpr Tp y() const {
         return Get(1);
     }
 
-    Tp z() const {
+    constexpr Tp z() const {
         return Get(2);
     }
 
@@ -113,12 +109,6 @@ public:
         return *this;
     }
 
-    Point<Tp, dim>& operator=(const Point<Tp, dim>& oth) {
-        for (size_t i = 0; i < dim; ++i)
-            coordinates_[i] = static_cast<Tp>(oth.coordinates_[i]);
-        return *this;
-    }
-
     Pnt operator-(const Pnt& oth) const {
         Pnt temp;
         for (size_t i = 0; i < dim; ++i) 
@@ -162,7 +152,7 @@ public:
     }
 
     bool operator<(const Point<Tp, dim>& oth) const {
-        for (size_t i = 0; i < sz; ++i)
+        for (size_t i = 0; i < dim; ++i)
             if (coordinates_[i] < oth.coordinates_[i])
                 return true;
             else if (coordinates_[i] > oth.coordinates_[i])
@@ -175,21 +165,6 @@ public:
         return !(*this < oth) && !(oth < *this);
     }
 
-private:
-    template<class FirstCoordinateType, class...CoordinateType>
-    void Init(int lev, FirstCoordinateType first, CoordinateType...coordinates) {
-        static_assert(std::is_convertible<FirstCoordinateType, Tp>::value,
-                "types must be convertible to Tp");
-
-        coordinates_[lev] = static_cast<Tp>(first);
-        Init(lev + 1, coordinates...);
-    }
-
-    void Init(int lev) {
-        assert(lev == dim);
-    }
-
-
 private:
     Tp coordinates_[dim];
 
@@ -215,6 +190,9 @@ private:
     friend std::istream& operator >> (std::istream& in, Point<T, d>& point);
 };
 
+template<typename Tp, size_t dim>
+constexpr size_t Point<Tp, dim>::dimension;
+
 template<typename Tp, size_t dim = 2>
 std::ostream& operator << (std::ostream& out, const Point<Tp, dim>& point) {
     for (const Tp& x: point.coordinates_) 
@@ -10,11 +10,15 @@
 #include <list>
 #include <iterator>
 #include <unordered_map>
+#include <atomic>
+#include <mutex>
 #include "point.h"
 #include "vector.h"
 #include "circular_list.h"
 #include "segment.h"
 #include "circle.h"
+#include "triangle_mesh.h"
+#include "predicates.h"
 
 namespace geometry {
 
@@ -22,8 +26,28 @@ enum Location : int {
     INSIDE, BORDER, OUTSIDE
 };
 
-template<typename Tp, size_t dim = 2> 
-class Polygon {
+// result of `Validate`, the first defect found in this order
+enum Validity : int {
+    VALID, TOO_FEW_VERTICES, ZERO_LENGTH_EDGE, DUPLICATE_VERTEX, SELF_INTERSECTION, CLOCKWISE
+};
+
+template<typename Tp, size_t dim>
+class Polygon;
+
+// summary of a polygon found in one pass over its vertices
+template<typename Tp, size_t dim = 2>
+struct PolygonProperties {
+    double square; // positive for counterclockwise order
+    double perimeter;
+    Point<Tp, dim> min; // corners of the bounding box
+    Point<Tp, dim> max;
+    bool convex;
+};
+
+// non-owning view of a polygon whose vertices are stored in caller's memory
+// all algorithms are const, they neither copy nor reorder the vertices
+template<typename Tp, size_t dim = 2>
+class PolygonView {
 private:
     typedef Polygon<Tp, dim> Poly;
     typedef Vector<Tp, dim> Vec;
@@ -31,106 +55,142 @@ private:
     typedef CircularList<std::pair<const Pnt*, size_t>> CircularPoints;
     typedef typename CircularPoints::iterator CPointsIterator;
 
-public: 
-    Polygon() 
-        : sz_(0)
+public:
+    constexpr PolygonView()
+        : points_(nullptr)
+        , sz_(0)
     {}
 
-    explicit Polygon(size_t sz)
-        : sz_(sz)
+    constexpr PolygonView(const Pnt* points, size_t sz)
+        : points_(points)
+        , sz_(sz)
     {}
-        
-    template<class...PointType, typename = typename 
-        std::enable_if<
-            all_true<
-                std::is_same<
-                    typename std::decay<PointType>::type, Pnt
-                >::value...
-            >::value
-        >::type
-    >
-    Polygon(const PointType& ... points) {
-        static_assert(sizeof...(PointType) >= 3,
-                "count of points must be >= 3");
-        points_ = {points...};
-    }
 
-    explicit Polygon(std::vector<Pnt>&& points)
-        : points_(std::move(points))
+    PolygonView(const std::vector<Pnt>& points)
+        : points_(points.data())
         , sz_(points.size())
     {}
 
-    double Perimeter() const {
-        assert(points_.size() >= 3);
-        double res = 0;
-        for (size_t i = 0; i < points_.size() - 1; ++i) {
-            res += Vec(points_[i], points_[i + 1]).Length();            
-        }
-        res += Vec(points_.back(), points_[0]).Length();
+    size_t Size() const {
+        return sz_;
+    }
 
-        return res;
+    const Pnt* Data() const {
+        return points_;
     }
 
-    double Square() const {
-        assert(points_.size() >= 3);
-        double res = 0;
-        for (size_t i = 1; i < points_.size() - 1; ++i) {
-            Vec first(points_[0], points_[i]);
-            Vec second(points_[0], points_[i + 1]);
-            res += first.CrossProduct(second).Length() / 2;            
-        }
+    const Pnt& operator[](size_t id) const {
+        assert(id < sz_);
 
-        return res;
+        return points_[id];
     }
 
-    Circle<double> MinDisk() {
-        if (points_.size() == 1) {
-            return Circle<double>(points_[0]);
-        } else if (points_.size() == 2)
-            return Circle<double>(points_[0], points_[1]);
+    PolygonProperties<Tp, dim> Properties() const {
+        assert(dim == 2);
+        assert(sz_ >= 3);
+        typedef typename PredicateType<Tp>::type T;
+
+        PolygonProperties<Tp, dim> res;
+        T square = 0;
+        Tp min_x = points_[0].x(), min_y = points_[0].y();
+        Tp max_x = min_x, max_y = min_y;
+        int turn = 0;
+        int direction = 0;
+        size_t direction_changes = 0;
+
+        res.perimeter = 0;
+        res.convex = true;
+        for (size_t i = 0; i < sz_; ++i) {
+            const Pnt& a = points_[i];
+            const Pnt& b = points_[i + 1 < sz_ ? i + 1 : 0];
+            const Pnt& c = points_[i + 2 < sz_ ? i + 2 : i + 2 - sz_];
+
+            square += Vec(points_[0], a).template Cross<T>(Vec(points_[0], b));
+            res.perimeter += Vec(a, b).Length();
+            min_x = std::min(min_x, a.x());
+            min_y = std::min(min_y, a.y());
+            max_x = std::max(max_x, a.x());
+            max_y = std::max(max_y, a.y());
+
+            // convex if it turns to one side only and goes around once
+            int rotate = Vec(a, b).Rotate(Vec(b, c));
+            if (rotate != 0) {
+                if (turn != 0 && rotate != turn)
+                    res.convex = false;
+                turn = rotate;
+            }
 
-        std::random_shuffle(points_.begin(), points_.end());
-        Circle<double> res(points_[0], points_[1]);
+            int dx = (a.x() < b.x()) - (b.x() < a.x());
+            if (dx != 0) {
+                if (direction != 0 && dx != direction)
+                    ++direction_changes;
+                direction = dx;
+            }
+        }
 
-        for (size_t i = 2; i < points_.size(); ++i) 
-            if (!res.Inside(points_[i])) 
-                res = MinDiskWithPoint(i, points_[i]);
+        res.convex = res.convex && direction_changes <= 2;
+        res.square = static_cast<double>(square) / 2;
+        res.min = Pnt(min_x, min_y);
+        res.max = Pnt(max_x, max_y);
 
         return res;
     }
 
-    Circle<double> MinDiskWithPoint(size_t r, const Pnt& p) {
-        assert(points_.size() > 2);
-        Circle<double> res(points_[0], p);
-        for (size_t i = 1; i < r; ++i) 
-            if (!res.Inside(points_[i]))
-                res = MinDiskWith2Points(i, points_[i], p);
-        return res;
+    double Perimeter() const {
+        return Properties().perimeter;
     }
 
-    Circle<double> MinDiskWith2Points(size_t r, const Pnt& p, const Pnt& q) {
-        assert(points_.size() > 2);
-        Circle<double> res(p, q);
-        for (size_t i = 0; i < r; ++i) 
-            if (!res.Inside(points_[i]))
-                res = Circle<double>(points_[i], p, q);
-        return res;
+    double SignedSquare() const {
+        return Properties().square;
+    }
+
+    double Square() const {
+        return std::abs(SignedSquare());
+    }
+
+    std::pair<Pnt, Pnt> BoundingBox() const {
+        PolygonProperties<Tp, dim> properties = Properties();
+        return {properties.min, properties.max};
+    }
+
+    bool IsConvex() const {
+        return Properties().convex;
     }
 
     bool ClockwiseOrder() const {
-        return Vec(points_[0], points_[1]).Rotate(Vec(points_[1], points_[2])) == -1;
+        return SignedSquare() < 0;
     }
 
     bool CounterclockwiseOrder() const {
         return !ClockwiseOrder();
     }
 
-    std::pair<Pnt, Pnt> GetDiameter() {
+    // shuffles pointers to the vertices instead of the vertices
+    Circle<double> MinDisk() const {
+        if (sz_ == 1) {
+            return Circle<double>(points_[0]);
+        } else if (sz_ == 2)
+            return Circle<double>(points_[0], points_[1]);
+
+        std::vector<const Pnt*> points(sz_);
+        for (size_t i = 0; i < sz_; ++i)
+            points[i] = points_ + i;
+        std::random_shuffle(points.begin(), points.end());
+        Circle<double> res(*points[0], *points[1]);
+
+        for (size_t i = 2; i < sz_; ++i)
+            if (!res.Inside(*points[i]))
+                res = MinDiskWithPoint(points, i, *points[i]);
+
+        return res;
+    }
+
+    std::pair<Pnt, Pnt> GetDiameter() const {
         return ConvexHull().GetConvexDiameter();
     }
 
     // returns diameter of convex polygon
-    std::pair<Pnt, Pnt> GetConvexDiameter() {
+    std::pair<Pnt, Pnt> GetConvexDiameter() const {
         using namespace std;
 
         assert(CounterclockwiseOrder());
@@ -143,7 +203,7 @@ public:
         int id1 = -1, id2;
 
         for (size_t k = 0; k < 2 * sz; ++k) {
-            long long dist = points_[i].template Distance2<long long>(points_[j]); 
+            long long dist = points_[i].template Distance2<long long>(points_[j]);
             if (dist > max_dist) {
                 max_dist = dist;
                 id1 = i;
@@ -152,7 +212,7 @@ public:
 
             ni = (i + 1) % sz;
             nj = (j + 1) % sz;
-            
+
             if (Vec(points_[i], points_[ni]).Rotate(Vec(points_[j], points_[nj])) >= 0)
                 j = nj;
             else
@@ -163,54 +223,91 @@ public:
         return {points_[id1], points_[id2]};
     }
 
-    // return convex polygon in counterclockwise order
-    Poly ConvexHull() {
+    // writes vertices of the convex hull in counterclockwise order into `res`
+    void ConvexHull(std::vector<Pnt>& res) const {
         assert(dim == 2);
-        size_t min_id = std::distance(points_.begin(), 
-                                      std::min_element(points_.begin(), points_.end()));
+        std::vector<Pnt> points(points_, points_ + sz_);
+        size_t min_id = std::distance(points.begin(),
+                                      std::min_element(points.begin(), points.end()));
 
         if (min_id != 0) {
-            std::swap(points_[min_id], points_[0]);
+            std::swap(points[min_id], points[0]);
         }
 
-        std::sort(points_.begin() + 1, points_.end(), [this] (const Pnt& a, const Pnt& b) -> bool {
-            Vec first = Vec(points_[0], a);
-            Vec second = Vec(points_[0], b);
+        std::sort(points.begin() + 1, points.end(), [&points] (const Pnt& a, const Pnt& b) -> bool {
+            Vec first = Vec(points[0], a);
+            Vec second = Vec(points[0], b);
             if (first.Rotate(second) == 0) {
-                return first.Length() < second.Length();
+                return first.Length2() < second.Length2();
             }
 
             return first.Rotate(second) > 0;
         });
 
-        Poly res;
-        std::vector<Pnt> & new_points = res.points_;
-        for (size_t i = 0; i < points_.size(); ++i) {
-            while (new_points.size() >= 2) {
-                Vec first(new_points[new_points.size() - 2], new_points.back());
-                Vec second(new_points.back(), points_[i]);
+        res.clear();
+        for (size_t i = 0; i < points.size(); ++i) {
+            while (res.size() >= 2) {
+                Vec first(res[res.size() - 2], res.back());
+                Vec second(res.back(), points[i]);
                 if (first.Rotate(second) > 0)
                     break;
-                new_points.pop_back();
+                res.pop_back();
             }
-            new_points.push_back(points_[i]);
+            res.push_back(points[i]);
         }
+    }
 
-        return res;
+    // return convex polygon in counterclockwise order
+    Poly ConvexHull() const {
+        std::vector<Pnt> res;
+        ConvexHull(res);
+        return Poly(std::move(res));
     }
 
     // returns vector of triples
     // count of result triangles = size of result vector / 3
     std::vector<Tp> Triangulation() const {
-        using std::make_tuple;
+        TriangleMesh<> mesh;
+        Triangulation(mesh);
 
-        assert(points_.size() >= 3);
         std::vector<Tp> res;
-        res.reserve(3 * (points_.size() - 2));
+        res.reserve(mesh.Triangles().size());
+        for (auto v: mesh.Triangles())
+            res.push_back(v + 1);
+
+        return res;
+    }
 
+    // writes triangulation into `mesh` with adjacency, vertex ids are indices of points
+    template<typename Index>
+    void Triangulation(TriangleMesh<Index>& mesh) const {
+        const Index NONE = TriangleMesh<Index>::NONE;
+
+        assert(sz_ >= 3);
+        mesh.Clear();
+        mesh.ResizeVertices(sz_);
+        mesh.Reserve(sz_ - 2);
+
+        // outer[v] - twin of the edge from `v` to the next vertex of the rest polygon
+        std::vector<Index> outer(sz_, NONE);
+        auto cut = [&mesh, &outer] (const CPointsIterator& cur_point, bool last) {
+            Index a = static_cast<Index>((cur_point - 1)->second - 1);
+            Index b = static_cast<Index>(cur_point->second - 1);
+            Index c = static_cast<Index>((cur_point + 1)->second - 1);
+
+            Index t = mesh.AddTriangle(a, b, c);
+            mesh.SetTwin(3 * t, outer[a]);
+            mesh.SetTwin(3 * t + 1, outer[b]);
+            if (last)
+                mesh.SetTwin(3 * t + 2, outer[c]);
+            outer[a] = 3 * t + 2;
+        };
+
+        // list nodes live in the arena of the current thread until the end of triangulation
+        ArenaScope scope;
         CircularPoints points;
-        for (size_t i = 0; i < points_.size(); ++i) {
-            points.push_back(std::make_pair(&points_[i], i + 1));
+        for (size_t i = 0; i < sz_; ++i) {
+            points.push_back(std::make_pair(points_ + i, i + 1));
         }
 
         CircularList<CPointsIterator> ears;
@@ -224,10 +321,8 @@ public:
         if (points.size() > 3)
         for (auto it = ears.begin(); ears.size() >= 2;) {
             CPointsIterator cur_point = *it;
-            res.push_back((cur_point - 1)->second);
-            res.push_back(cur_point->second);
-            res.push_back((cur_point + 1)->second);
-            
+            cut(cur_point, false);
+
             points.erase(--cur_point + 1);
             if (points.size() == 3) {
                 break;
@@ -252,40 +347,36 @@ public:
             ears.erase(++it - 1);
         }
 
-        assert(points.size() == 3);
-        auto it = points.begin();
-        res.push_back(it->second);
-        res.push_back((it + 1)->second);
-        res.push_back((it + 2)->second);
-
-        return res;
+        // ear clipping of a non-simple polygon may stop early, with less than sz_ - 2 triangles
+        if (points.size() == 3)
+            cut(points.begin() + 1, true);
     }
 
-    Location CheckInside(const Pnt& p) {
+    Location CheckInside(const Pnt& p) const {
         assert(dim == 2);
 
-        points_.push_back(points_[0]);
         size_t cnt_intersections = 0;
-        for (size_t i = 0; i < points_.size() - 1; ++i) {
-            if (Segment<int>(points_[i], points_[i + 1]).Inside(p)) 
+        for (size_t i = 0; i < sz_; ++i) {
+            const Pnt& a = points_[i];
+            const Pnt& b = points_[i + 1 < sz_ ? i + 1 : 0];
+            if (Segment<Tp>(a, b).Inside(p))
                 return INSIDE;
 
-            if (points_[i].y() == points_[i + 1].y()) 
+            if (a.y() == b.y())
                 continue;
 
-            double t2 = (p.y() - points_[i].y()) * 1.0 / (points_[i + 1].y() - points_[i].y());
-            double t1 = points_[i].x() - p.x() + (points_[i + 1].x() - points_[i].x()) * t2;
+            double t2 = (p.y() - a.y()) * 1.0 / (b.y() - a.y());
+            double t1 = a.x() - p.x() + (b.x() - a.x()) * t2;
 
-            cnt_intersections += t2 >= 0 && t2 <= 1 && t1 >= 0 && p.y() != std::max(points_[i].y(), points_[i + 1].y());
+            cnt_intersections += t2 >= 0 && t2 <= 1 && t1 >= 0 && p.y() != std::max(a.y(), b.y());
         }
-        points_.pop_back();
 
         return cnt_intersections % 2 == 0 ? OUTSIDE : INSIDE;
     }
 
-    Location CheckConvexInside(const Pnt& p) {
+    Location CheckConvexInside(const Pnt& p) const {
         int l = 1;
-        int r = static_cast<int>(points_.size()) - 1;
+        int r = static_cast<int>(sz_) - 1;
 
         Vec pv = Vec(points_[0], p);
         Vec lv = Vec(points_[0], points_[l]);
@@ -295,7 +386,7 @@ public:
         int rvr = rv.Rotate(pv);
         if (lvr * rvr > 0)
             return OUTSIDE;
-        else if (lvr == 0) 
+        else if (lvr == 0)
             return Segment<Tp>(points_[0], points_[l]).Inside(p) ? BORDER : OUTSIDE;
         else if (rvr == 0)
             return Segment<Tp>(points_[0], points_[r]).Inside(p) ? BORDER : OUTSIDE;
@@ -322,23 +413,58 @@ public:
         return OUTSIDE;
     }
 
-    size_t Size() const {
-        return points_.size();
-    }
+    // checks what `Triangulation` expects: a simple polygon in counterclockwise order
+    // O(n log n): duplicates are found by sorting, crossings by the sweep of `FindIntersection`,
+    // where neighbour edges may only share their common vertex
+    Validity Validate() const {
+        assert(dim == 2);
+        if (sz_ < 3)
+            return TOO_FEW_VERTICES;
 
-    const Pnt& operator[](size_t id) const {
-        assert(id < sz_);
+        for (size_t i = 0; i < sz_; ++i) {
+            if (points_[i] == points_[i + 1 < sz_ ? i + 1 : 0])
+                return ZERO_LENGTH_EDGE;
+        }
 
-        return points_[id];
+        std::vector<Pnt> sorted(points_, points_ + sz_);
+        std::sort(sorted.begin(), sorted.end());
+        if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+            return DUPLICATE_VERTEX;
+
+        std::vector<Segment<Tp>> edges;
+        edges.reserve(sz_);
+        for (size_t i = 0; i < sz_; ++i)
+            edges.push_back(Segment<Tp>(points_[i], points_[i + 1 < sz_ ? i + 1 : 0]));
+
+        int n = static_cast<int>(sz_);
+        auto adjacent = [n] (int i, int j) {
+            int d = std::abs(i - j);
+            return d == 1 || d == n - 1;
+        };
+        if (FindIntersection(edges, adjacent).first != -1)
+            return SELF_INTERSECTION;
+
+        return ClockwiseOrder() ? CLOCKWISE : VALID;
     }
 
-    Pnt& operator[](size_t id) {
-        assert(id < sz_);
+private:
+    static Circle<double> MinDiskWithPoint(const std::vector<const Pnt*>& points, size_t r, const Pnt& p) {
+        Circle<double> res(*points[0], p);
+        for (size_t i = 1; i < r; ++i)
+            if (!res.Inside(*points[i]))
+                res = MinDiskWith2Points(points, i, *points[i], p);
+        return res;
+    }
 
-        return points_[id];
+    static Circle<double> MinDiskWith2Points(const std::vector<const Pnt*>& points, size_t r,
+                                             const Pnt& p, const Pnt& q) {
+        Circle<double> res(p, q);
+        for (size_t i = 0; i < r; ++i)
+            if (!res.Inside(*points[i]))
+                res = Circle<double>(*points[i], p, q);
+        return res;
     }
 
-private:
     bool IsEar(const CircularPoints& points, const CPointsIterator& cur_it) const
     {
         const Pnt& prev = *(cur_it - 1)->first;
@@ -352,11 +478,11 @@ private:
         auto it = points.begin();
         do {
             auto point = *it;
-            if (*point.first == prev || 
-                *point.first == cur || 
-                *point.first == next) 
+            if (*point.first == prev ||
+                *point.first == cur ||
+                *point.first == next)
             {
-                continue;    
+                continue;
             }
 
             const Pnt& cur_p = *point.first;
@@ -374,10 +500,219 @@ private:
         return true;
     }
 
+private:
+    const Pnt* points_;
+    size_t sz_;
+};
+
+// owns its vertices, algorithms run on `View()`
+template<typename Tp, size_t dim = 2>
+class Polygon {
+private:
+    typedef Polygon<Tp, dim> Poly;
+    typedef Point<Tp, dim> Pnt;
+
+public:
+    Polygon()
+        : sz_(0)
+        , cache_(nullptr)
+    {}
+
+    explicit Polygon(size_t sz)
+        : sz_(sz)
+        , cache_(nullptr)
+    {}
+
+    template<class...PointType, typename = typename
+        std::enable_if<
+            all_true<
+                std::is_same<
+                    typename std::decay<PointType>::type, Pnt
+                >::value...
+            >::value
+        >::type
+    >
+    Polygon(const PointType& ... points)
+        : sz_(sizeof...(PointType))
+        , cache_(nullptr)
+    {
+        static_assert(sizeof...(PointType) >= 3,
+                "count of points must be >= 3");
+        points_ = {points...};
+    }
+
+    explicit Polygon(std::vector<Pnt>&& points)
+        : points_(std::move(points))
+        , sz_(points_.size())
+        , cache_(nullptr)
+    {}
+
+    // the cache isn't copied, it's filled again on request
+    Polygon(const Poly& oth)
+        : points_(oth.points_)
+        , sz_(oth.sz_)
+        , cache_(nullptr)
+    {}
+
+    Polygon(Poly&& oth)
+        : points_(std::move(oth.points_))
+        , sz_(oth.sz_)
+        , cache_(oth.cache_.exchange(nullptr))
+    {}
+
+    Poly& operator=(Poly oth) {
+        points_.swap(oth.points_);
+        std::swap(sz_, oth.sz_);
+        cache_ = oth.cache_.exchange(cache_.load());
+        return *this;
+    }
+
+    ~Polygon() {
+        delete cache_.load();
+    }
+
+    PolygonView<Tp, dim> View() const {
+        return PolygonView<Tp, dim>(points_.data(), points_.size());
+    }
+
+    // derived properties are computed on the first request and cached until the polygon
+    // is changed by `SetPoint` or `operator>>`, concurrent requests compute them once
+    double Perimeter() const {
+        return Properties().perimeter;
+    }
+
+    // positive for counterclockwise order, shoelace formula
+    double SignedSquare() const {
+        return Properties().square;
+    }
+
+    double Square() const {
+        return std::abs(SignedSquare());
+    }
+
+    // lower left and upper right corners of the bounding box
+    std::pair<Pnt, Pnt> BoundingBox() const {
+        const PolygonProperties<Tp, dim>& properties = Properties();
+        return {properties.min, properties.max};
+    }
+
+    bool IsConvex() const {
+        return Properties().convex;
+    }
+
+    Circle<double> MinDisk() const {
+        return View().MinDisk();
+    }
+
+    bool ClockwiseOrder() const {
+        return SignedSquare() < 0;
+    }
+
+    bool CounterclockwiseOrder() const {
+        return !ClockwiseOrder();
+    }
+
+    std::pair<Pnt, Pnt> GetDiameter() const {
+        return ConvexHull().GetConvexDiameter();
+    }
+
+    // returns diameter of convex polygon
+    std::pair<Pnt, Pnt> GetConvexDiameter() const {
+        return View().GetConvexDiameter();
+    }
+
+    // return convex polygon in counterclockwise order
+    Poly ConvexHull() const {
+        Cache& cache = GetCache();
+        std::call_once(cache.hull_flag, [this, &cache] {
+            View().ConvexHull(cache.hull);
+        });
+
+        return Poly(std::vector<Pnt>(cache.hull));
+    }
+
+    // returns vector of triples
+    // count of result triangles = size of result vector / 3
+    std::vector<Tp> Triangulation() const {
+        return View().Triangulation();
+    }
+
+    // writes triangulation into `mesh` with adjacency, vertex ids are indices of points
+    template<typename Index>
+    void Triangulation(TriangleMesh<Index>& mesh) const {
+        View().Triangulation(mesh);
+    }
+
+    Location CheckInside(const Pnt& p) const {
+        return View().CheckInside(p);
+    }
+
+    Location CheckConvexInside(const Pnt& p) const {
+        return View().CheckConvexInside(p);
+    }
+
+    Validity Validate() const {
+        return View().Validate();
+    }
+
+    size_t Size() const {
+        return points_.size();
+    }
+
+    const Pnt& operator[](size_t id) const {
+        assert(id < sz_);
+
+        return points_[id];
+    }
+
+    void SetPoint(size_t id, const Pnt& p) {
+        assert(id < sz_);
+        Invalidate();
+
+        points_[id] = p;
+    }
+
+private:
+    struct Cache {
+        std::once_flag properties_flag;
+        std::once_flag hull_flag;
+        PolygonProperties<Tp, dim> properties;
+        std::vector<Pnt> hull;
+    };
+
+    // only the non-const methods drop the cache, so nobody reads it meanwhile
+    void Invalidate() {
+        delete cache_.exchange(nullptr);
+    }
+
+    // threads racing to create the cache keep the first one
+    Cache& GetCache() const {
+        Cache* cache = cache_.load(std::memory_order_acquire);
+        if (cache == nullptr) {
+            Cache* created = new Cache();
+            if (cache_.compare_exchange_strong(cache, created, std::memory_order_acq_rel))
+                cache = created;
+            else
+                delete created;
+        }
+        return *cache;
+    }
+
+    const PolygonProperties<Tp, dim>& Properties() const {
+        Cache& cache = GetCache();
+        std::call_once(cache.properties_flag, [this, &cache] {
+            cache.properties = View().Properties();
+        });
+
+        return cache.properties;
+    }
+
 private:
     std::vector<Pnt> points_;
     size_t sz_;
 
+    mutable std::atomic<Cache*> cache_;
+
 private:
     template<typename T, size_t d>
     friend std::ostream& operator << (std::ostream& out, const Polygon<T, d>& polygon);
@@ -408,6 +743,7 @@ std::ostream& operator << (std::ostream& out, const Polygon<Tp, dim>& polygon) {
 template<typename Tp, size_t dim = 2>
 std::istream& operator >> (std::istream& in, Polygon<Tp, dim>& polygon) {
     polygon.points_.clear();
+    polygon.Invalidate();
 
     if (polygon.sz_ == 0)
         in >> polygon.sz_;
@@ -0,0 +1,245 @@
+#ifndef POLYGON_INDEX_H
+#define POLYGON_INDEX_H
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+#include "point.h"
+#include "polygon.h"
+#include "parallel.h"
+
+namespace geometry {
+
+// R-tree over bounding boxes of polygons, answers which polygons contain a point
+// the tree is packed by Sort-Tile-Recursive (Leutenegger et al.): nodes of every level
+// are sorted by x in vertical slices, then by y inside a slice and grouped by `FANOUT`,
+// so children of a node are consecutive; candidates are refined by `CheckInside`
+// inserted polygons wait in a small unsorted list and removed ones are only marked,
+// the tree is packed again when either of them grows too large
+// ids of polygons are stable; queries may run concurrently, updates may not
+template<typename Tp>
+class PolygonIndex {
+public:
+    typedef Point<Tp> Pnt;
+
+public:
+    PolygonIndex()
+        : alive_count_(0)
+        , leaves_(0)
+    {}
+
+    explicit PolygonIndex(const std::vector<Polygon<Tp>>& polygons)
+        : polygons_(polygons)
+        , alive_(polygons.size(), 1)
+        , alive_count_(polygons.size())
+        , leaves_(0)
+    {
+        boxes_.reserve(polygons_.size());
+        for (const auto& polygon: polygons_)
+            boxes_.push_back(GetBox(polygon));
+        Pack();
+    }
+
+    // returns id of the polygon
+    size_t Insert(const Polygon<Tp>& polygon) {
+        polygons_.push_back(polygon);
+        boxes_.push_back(GetBox(polygon));
+        alive_.push_back(1);
+        ++alive_count_;
+        pending_.push_back(polygons_.size() - 1);
+
+        if (pending_.size() > std::max<size_t>(MIN_PENDING, alive_count_ / 8))
+            Pack();
+        return polygons_.size() - 1;
+    }
+
+    void Remove(size_t id) {
+        assert(id < polygons_.size() && alive_[id]);
+        alive_[id] = 0;
+        --alive_count_;
+        polygons_[id] = Polygon<Tp>();
+
+        if (entries_.size() > MIN_PENDING && alive_count_ < entries_.size() / 2)
+            Pack();
+    }
+
+    size_t Size() const {
+        return alive_count_;
+    }
+
+    const Polygon<Tp>& GetPolygon(size_t id) const {
+        return polygons_[id];
+    }
+
+    // appends ids of polygons containing `p` (including their boundary) to `res`
+    void Query(const Pnt& p, std::vector<size_t>& res) const {
+        for (size_t id: pending_)
+            Refine(id, p, res);
+
+        if (nodes_.empty())
+            return;
+
+        // at most FANOUT - 1 siblings wait on every level
+        size_t stack[256];
+        size_t top = 0;
+        stack[top++] = nodes_.size() - 1;
+        while (top > 0) {
+            size_t id = stack[--top];
+            const Node& node = nodes_[id];
+            if (!node.box.Contains(p))
+                continue;
+
+            if (id < leaves_) {
+                for (size_t i = node.first; i < node.first + node.count; ++i)
+                    Refine(entries_[i], p, res);
+            } else {
+                for (size_t i = node.first; i < node.first + node.count; ++i)
+                    stack[top++] = i;
+            }
+        }
+    }
+
+    // batch version of `Query`, result of queries[i] is res[offsets[i]], ..., res[offsets[i + 1] - 1]
+    void Query(const std::vector<Pnt>& queries, std::vector<size_t>& res,
+               std::vector<size_t>& offsets, size_t threads = 1) const
+    {
+        size_t chunks = ThreadsCount(threads, queries.size());
+        std::vector<std::vector<size_t>> chunk_res(chunks);
+        offsets.assign(queries.size() + 1, 0);
+
+        ParallelChunks(queries.size(), chunks, [&] (size_t chunk, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                size_t before = chunk_res[chunk].size();
+                Query(queries[i], chunk_res[chunk]);
+                offsets[i + 1] = chunk_res[chunk].size() - before;
+            }
+        });
+
+        for (size_t i = 0; i < queries.size(); ++i)
+            offsets[i + 1] += offsets[i];
+
+        res.clear();
+        res.reserve(offsets.back());
+        for (const auto& chunk: chunk_res)
+            res.insert(res.end(), chunk.begin(), chunk.end());
+    }
+
+private:
+    static const size_t FANOUT = 16;
+    static const size_t MIN_PENDING = 64;
+
+    struct Box {
+        Tp min_x, min_y, max_x, max_y;
+
+        bool Contains(const Pnt& p) const {
+            return min_x <= p.x() && p.x() <= max_x && min_y <= p.y() && p.y() <= max_y;
+        }
+
+        void Extend(const Box& oth) {
+            min_x = std::min(min_x, oth.min_x);
+            min_y = std::min(min_y, oth.min_y);
+            max_x = std::max(max_x, oth.max_x);
+            max_y = std::max(max_y, oth.max_y);
+        }
+
+        // doubled center avoids division for integer coordinates
+        Tp CenterX() const {
+            return min_x + max_x;
+        }
+
+        Tp CenterY() const {
+            return min_y + max_y;
+        }
+    };
+
+    // `first`, ..., `first + count - 1` are entries for leaves and nodes otherwise
+    struct Node {
+        Box box;
+        size_t first;
+        size_t count;
+    };
+
+    static Box GetBox(const Polygon<Tp>& polygon) {
+        std::pair<Pnt, Pnt> box = polygon.BoundingBox();
+        return Box{box.first.x(), box.first.y(), box.second.x(), box.second.y()};
+    }
+
+    void Refine(size_t id, const Pnt& p, std::vector<size_t>& res) const {
+        if (alive_[id] && boxes_[id].Contains(p) && polygons_[id].CheckInside(p) != OUTSIDE)
+            res.push_back(id);
+    }
+
+    // sorts `items` into tiles: ceil(sqrt(P)) vertical slices of P = ceil(n / FANOUT) groups
+    static void SortTiles(std::vector<Node>& items) {
+        size_t groups = (items.size() + FANOUT - 1) / FANOUT;
+        size_t slices = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(groups))));
+        size_t slice = slices * FANOUT;
+
+        std::sort(items.begin(), items.end(), [] (const Node& a, const Node& b) {
+            return a.box.CenterX() < b.box.CenterX();
+        });
+        for (size_t begin = 0; begin < items.size(); begin += slice) {
+            size_t end = std::min(items.size(), begin + slice);
+            std::sort(items.begin() + begin, items.begin() + end, [] (const Node& a, const Node& b) {
+                return a.box.CenterY() < b.box.CenterY();
+            });
+        }
+    }
+
+    // groups consecutive `items` by FANOUT, children of the group start at `base`
+    static std::vector<Node> Group(const std::vector<Node>& items, size_t base) {
+        std::vector<Node> res;
+        for (size_t begin = 0; begin < items.size(); begin += FANOUT) {
+            size_t end = std::min(items.size(), begin + FANOUT);
+            Node node{items[begin].box, base + begin, end - begin};
+            for (size_t i = begin + 1; i < end; ++i)
+                node.box.Extend(items[i].box);
+            res.push_back(node);
+        }
+        return res;
+    }
+
+    // leaves are nodes 0, ..., leaves_ - 1, the root is the last node
+    void Pack() {
+        pending_.clear();
+        entries_.clear();
+        nodes_.clear();
+        leaves_ = 0;
+
+        std::vector<Node> level;
+        for (size_t id = 0; id < polygons_.size(); ++id)
+            if (alive_[id])
+                level.push_back(Node{boxes_[id], id, 0});
+        if (level.empty())
+            return;
+
+        SortTiles(level);
+        for (const Node& item: level)
+            entries_.push_back(item.first);
+        level = Group(level, 0);
+        leaves_ = level.size();
+
+        while (level.size() > 1) {
+            SortTiles(level);
+            size_t base = nodes_.size();
+            nodes_.insert(nodes_.end(), level.begin(), level.end());
+            level = Group(level, base);
+        }
+        nodes_.push_back(level[0]);
+    }
+
+private:
+    std::vector<Polygon<Tp>> polygons_;
+    std::vector<Box> boxes_;
+    std::vector<char> alive_;
+    size_t alive_count_;
+
+    std::vector<size_t> pending_;
+    std::vector<size_t> entries_;
+    std::vector<Node> nodes_;
+    size_t leaves_;
+};
+
+} // namespace geometry
+
+#endif // POLYGON_INDEX_H
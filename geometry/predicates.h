@@ -0,0 +1,497 @@
+#ifndef PREDICATES_H
+#define PREDICATES_H
+#include <type_traits>
+#include <vector>
+#include <limits>
+#include <cmath>
+#include "point.h"
+
+namespace geometry {
+
+// type used to evaluate predicates on coordinates of type `Tp`
+// integer coordinates are evaluated exactly while the determinants fit into `long long`
+// (|coordinate| < 2^30 for `Orientation`), `InCircle`, `InSphere` and `Orientation` in 3D
+// use `WideInteger` instead
+// floating point coordinates are evaluated exactly, `long double` is used by predicates
+// returning determinants (see `detail::PredicateSign`)
+template<typename Tp, bool = std::is_integral<Tp>::value>
+struct PredicateType {
+    typedef long double type;
+};
+
+template<typename Tp>
+struct PredicateType<Tp, true> {
+    typedef long long type;
+};
+
+// the widest integer type: `__int128` if the compiler has it, `long long` otherwise
+// `__extension__` keeps `-Wpedantic` quiet about the 128-bit types
+#ifdef __SIZEOF_INT128__
+__extension__ typedef __int128 Int128;
+__extension__ typedef unsigned __int128 UInt128;
+typedef Int128 WideInteger;
+#else
+typedef long long WideInteger;
+#endif
+
+// integer type of the determinant of `InCircle` for integer coordinates, it's exact
+// for |coordinate| <= 970235263 with `__int128` and <= 14804 with `long long`
+// (see `MaxInCircleCoordinate`)
+typedef WideInteger InCircleInteger;
+
+// the largest |coordinate| of integer points, for which every intermediate of the
+// determinant of `Orientation` in 3D fits into `WideInteger`: 6 * (2m)^3 < 2^127
+// with `__int128`, 2^63 with `long long`
+inline long long MaxOrientation3Coordinate() {
+    return sizeof(WideInteger) > sizeof(long long) ? 1524717566796LL : 577053LL;
+}
+
+// the same for `InSphere`: 72 * (2m)^5
+inline long long MaxInSphereCoordinate() {
+    return sizeof(WideInteger) > sizeof(long long) ? 9411641LL : 1319LL;
+}
+
+// type of `Distance2` results, exact for integer coordinates
+template<typename Tp>
+struct DistanceType {
+    typedef typename std::conditional<std::is_integral<Tp>::value, long long, double>::type type;
+};
+
+template<typename T>
+inline int Sign(T val) {
+    return (T(0) < val) - (val < T(0));
+}
+
+namespace detail {
+
+// exact sum of floating point components (Shewchuk's expansion), components don't overlap
+// and go in increasing order of magnitude, zero components are dropped
+// arithmetic is exact unless it overflows or underflows, it requires IEEE rounding
+// (no -ffast-math)
+template<typename F>
+class Expansion {
+public:
+    Expansion()
+        : size_(0)
+    {}
+
+    explicit Expansion(F a)
+        : size_(0)
+    {
+        if (a != 0)
+            Push(a);
+    }
+
+    // exact a - b
+    static Expansion Difference(F a, F b) {
+        F x = a - b;
+        F bv = a - x;
+        F av = x + bv;
+        F y = (a - av) + (bv - b);
+
+        Expansion res;
+        if (y != 0)
+            res.Push(y);
+        if (x != 0)
+            res.Push(x);
+        return res;
+    }
+
+    Expansion operator+(const Expansion& oth) const {
+        if (size_ < oth.size_)
+            return oth + *this;
+
+        Expansion res(*this);
+        for (size_t i = 0; i < oth.size_; ++i)
+            res.Grow(oth.Data()[i]);
+        return res;
+    }
+
+    Expansion operator-(const Expansion& oth) const {
+        Expansion res(*this);
+        for (size_t i = 0; i < oth.size_; ++i)
+            res.Grow(-oth.Data()[i]);
+        return res;
+    }
+
+    Expansion operator*(const Expansion& oth) const {
+        if (size_ < oth.size_)
+            return oth * *this;
+
+        Expansion res;
+        for (size_t i = 0; i < oth.size_; ++i)
+            res = i == 0 ? Scale(oth.Data()[i]) : res + Scale(oth.Data()[i]);
+        return res;
+    }
+
+    // the largest component has the sign of the sum
+    int Sign() const {
+        return size_ == 0 ? 0 : (Data()[size_ - 1] > 0 ? 1 : -1);
+    }
+
+private:
+    // x + y = a + b, x = fl(a + b)
+    static void TwoSum(F a, F b, F& x, F& y) {
+        x = a + b;
+        F bv = x - a;
+        F av = x - bv;
+        y = (a - av) + (b - bv);
+    }
+
+    // the same for |a| >= |b|
+    static void FastTwoSum(F a, F b, F& x, F& y) {
+        x = a + b;
+        y = b - (x - a);
+    }
+
+    // a = hi + lo, both halves have at most half of the significand bits (Dekker)
+    static void Split(F a, F& hi, F& lo) {
+        static const F SPLITTER = std::ldexp(F(1), (std::numeric_limits<F>::digits + 1) / 2) + 1;
+        F c = SPLITTER * a;
+        hi = c - (c - a);
+        lo = a - hi;
+    }
+
+    // x + y = a * b, x = fl(a * b)
+    static void TwoProduct(F a, F b, F& x, F& y) {
+        x = a * b;
+        F ahi, alo, bhi, blo;
+        Split(a, ahi, alo);
+        Split(b, bhi, blo);
+        y = alo * blo - (((x - ahi * bhi) - alo * bhi) - ahi * blo);
+    }
+
+    // short expansions of degenerate inputs don't allocate
+    const F* Data() const {
+        return large_.empty() ? small_ : large_.data();
+    }
+
+    F* Data() {
+        return large_.empty() ? small_ : large_.data();
+    }
+
+    void Push(F a) {
+        if (large_.empty() && size_ < SMALL) {
+            small_[size_++] = a;
+            return;
+        }
+        if (large_.empty())
+            large_.assign(small_, small_ + size_);
+        large_.push_back(a);
+        ++size_;
+    }
+
+    void Truncate(size_t size) {
+        if (!large_.empty())
+            large_.resize(size);
+        size_ = size;
+    }
+
+    void Grow(F b) {
+        size_t count = 0;
+        F q = b;
+        F* data = Data();
+        for (size_t i = 0; i < size_; ++i) {
+            F h;
+            TwoSum(q, data[i], q, h);
+            if (h != 0)
+                data[count++] = h;
+        }
+        Truncate(count);
+        if (q != 0)
+            Push(q);
+    }
+
+    Expansion Scale(F b) const {
+        Expansion res;
+        if (size_ == 0)
+            return res;
+
+        const F* data = Data();
+        F q, h;
+        TwoProduct(data[0], b, q, h);
+        if (h != 0)
+            res.Push(h);
+        for (size_t i = 1; i < size_; ++i) {
+            F hi, lo, sum;
+            TwoProduct(data[i], b, hi, lo);
+            TwoSum(q, lo, sum, h);
+            if (h != 0)
+                res.Push(h);
+            FastTwoSum(hi, sum, q, h);
+            if (h != 0)
+                res.Push(h);
+        }
+        if (q != 0)
+            res.Push(q);
+        return res;
+    }
+
+private:
+    static const size_t SMALL = 8;
+
+    F small_[SMALL];
+    std::vector<F> large_;
+    size_t size_;
+};
+
+// the same expression on magnitudes: bounds the rounding error of a determinant,
+// subtractions add
+template<typename T>
+struct Magnitude {
+    Magnitude operator+(const Magnitude& oth) const {
+        return Magnitude{value + oth.value};
+    }
+
+    Magnitude operator-(const Magnitude& oth) const {
+        return Magnitude{value + oth.value};
+    }
+
+    Magnitude operator*(const Magnitude& oth) const {
+        return Magnitude{value * oth.value};
+    }
+
+    T value;
+};
+
+// determinants of predicates on coordinate differences `d`, evaluated in `N`
+struct Orientation2Det {
+    static const int ERROR = 4;
+
+    template<typename N>
+    N operator()(const N* d) const {
+        return d[0] * d[3] - d[1] * d[2];
+    }
+};
+
+// `Orientation2Det` of projections of 3D points, evaluated as widely as `Orientation3Det`
+struct Projection2Det : Orientation2Det {};
+
+struct InCircleDet {
+    static const int ERROR = 12;
+
+    template<typename N>
+    N operator()(const N* d) const {
+        const N& adx = d[0], & ady = d[1];
+        const N& bdx = d[2], & bdy = d[3];
+        const N& cdx = d[4], & cdy = d[5];
+
+        return (adx * adx + ady * ady) * (bdx * cdy - cdx * bdy) +
+               (bdx * bdx + bdy * bdy) * (cdx * ady - adx * cdy) +
+               (cdx * cdx + cdy * cdy) * (adx * bdy - bdx * ady);
+    }
+};
+
+struct Orientation3Det {
+    static const int ERROR = 8;
+
+    template<typename N>
+    N operator()(const N* d) const {
+        const N& bax = d[0], & bay = d[1], & baz = d[2];
+        const N& cax = d[3], & cay = d[4], & caz = d[5];
+        const N& dax = d[6], & day = d[7], & daz = d[8];
+
+        return dax * (bay * caz - baz * cay) +
+               day * (baz * cax - bax * caz) +
+               daz * (bax * cay - bay * cax);
+    }
+};
+
+struct InSphereDet {
+    static const int ERROR = 18;
+
+    template<typename N>
+    N operator()(const N* d) const {
+        const N& aex = d[0], & aey = d[1], & aez = d[2];
+        const N& bex = d[3], & bey = d[4], & bez = d[5];
+        const N& cex = d[6], & cey = d[7], & cez = d[8];
+        const N& dex = d[9], & dey = d[10], & dez = d[11];
+
+        N ab = aex * bey - bex * aey;
+        N bc = bex * cey - cex * bey;
+        N cd = cex * dey - dex * cey;
+        N da = dex * aey - aex * dey;
+        N ac = aex * cey - cex * aey;
+        N bd = bex * dey - dex * bey;
+
+        N abc = aez * bc - bez * ac + cez * ab;
+        N bcd = bez * cd - cez * bd + dez * bc;
+        N cda = cez * da + dez * ac + aez * cd;
+        N dab = dez * ab + aez * bd + bez * da;
+
+        N alift = aex * aex + aey * aey + aez * aez;
+        N blift = bex * bex + bey * bey + bez * bez;
+        N clift = cex * cex + cey * cey + cez * cez;
+        N dlift = dex * dex + dey * dey + dez * dez;
+
+        return (dlift * abc - clift * dab) + (blift * cda - alift * bcd);
+    }
+};
+
+// integer type of determinant `Det`
+template<typename Det, typename Tp>
+struct IntegerType {
+    typedef typename PredicateType<Tp>::type type;
+};
+
+template<typename Tp>
+struct IntegerType<InCircleDet, Tp> {
+    typedef InCircleInteger type;
+};
+
+template<typename Tp>
+struct IntegerType<Projection2Det, Tp> {
+    typedef WideInteger type;
+};
+
+template<typename Tp>
+struct IntegerType<Orientation3Det, Tp> {
+    typedef WideInteger type;
+};
+
+template<typename Tp>
+struct IntegerType<InSphereDet, Tp> {
+    typedef WideInteger type;
+};
+
+// sign of determinant `Det` of differences p[i] - q[i] of integer coordinates
+template<typename Det, typename Tp, size_t count>
+int PredicateSign(const Tp (&p)[count], const Tp (&q)[count], std::false_type) {
+    typedef typename IntegerType<Det, Tp>::type T;
+    T diffs[count];
+    for (size_t i = 0; i < count; ++i)
+        diffs[i] = (T) p[i] - q[i];
+    return Sign(Det()(diffs));
+}
+
+// the same for floating point coordinates: the determinant is evaluated in `double`
+// (`long double` for wider coordinates), if it's within Det::ERROR units of roundoff
+// times the determinant of magnitudes (Shewchuk's stage A bound), it's evaluated exactly
+// on expansions
+template<typename Det, typename Tp, size_t count>
+int PredicateSign(const Tp (&p)[count], const Tp (&q)[count], std::true_type) {
+    typedef typename std::conditional<sizeof(Tp) <= sizeof(double), double, long double>::type T;
+    T diffs[count];
+    Magnitude<T> magnitudes[count];
+    for (size_t i = 0; i < count; ++i) {
+        diffs[i] = (T) p[i] - q[i];
+        magnitudes[i] = Magnitude<T>{std::abs(diffs[i])};
+    }
+
+    // every term of a zero permanent has an exactly zero difference
+    T det = Det()(diffs);
+    T bound = Det::ERROR * (std::numeric_limits<T>::epsilon() / 2) * Det()(magnitudes).value;
+    if (det > bound)
+        return 1;
+    if (-det > bound)
+        return -1;
+    if (bound == 0)
+        return 0;
+
+    Expansion<Tp> exact[count];
+    for (size_t i = 0; i < count; ++i)
+        exact[i] = Expansion<Tp>::Difference(p[i], q[i]);
+    return Det()(exact).Sign();
+}
+
+template<typename Det, typename Tp, size_t count>
+int PredicateSign(const Tp (&p)[count], const Tp (&q)[count]) {
+    return PredicateSign<Det>(p, q, std::is_floating_point<Tp>());
+}
+
+} // namespace detail
+
+// returns doubled signed square of triangle `a`, `b`, `c`
+// positive if points are in counterclockwise order
+template<typename RetType, typename Tp>
+RetType Orientation2(const Point<Tp, 2>& a, const Point<Tp, 2>& b, const Point<Tp, 2>& c) {
+    RetType abx = (RetType) b.x() - a.x();
+    RetType aby = (RetType) b.y() - a.y();
+    RetType acx = (RetType) c.x() - a.x();
+    RetType acy = (RetType) c.y() - a.y();
+
+    return abx * acy - aby * acx;
+}
+
+// returns: -1, 0, 1; 1 if `a`, `b`, `c` are in counterclockwise order
+template<typename Tp>
+int Orientation(const Point<Tp, 2>& a, const Point<Tp, 2>& b, const Point<Tp, 2>& c) {
+    // shared endpoints are frequent and can't be decided by the filter
+    if (c == a || c == b)
+        return 0;
+
+    Tp p[4] = {b.x(), b.y(), c.x(), c.y()};
+    Tp q[4] = {a.x(), a.y(), a.x(), a.y()};
+    return detail::PredicateSign<detail::Orientation2Det>(p, q);
+}
+
+// returns determinant of the incircle test in `RetType`, positive if `d` lies strictly
+// inside the circle through counterclockwise `a`, `b`, `c`
+// integer coordinates are exact in `__int128` for |coordinate| < 2^29
+template<typename RetType, typename Tp>
+RetType InCircle2(const Point<Tp, 2>& a, const Point<Tp, 2>& b,
+                  const Point<Tp, 2>& c, const Point<Tp, 2>& d)
+{
+    RetType diffs[6] = {
+        (RetType) a.x() - d.x(), (RetType) a.y() - d.y(),
+        (RetType) b.x() - d.x(), (RetType) b.y() - d.y(),
+        (RetType) c.x() - d.x(), (RetType) c.y() - d.y()
+    };
+    return detail::InCircleDet()(diffs);
+}
+
+// returns: -1, 0, 1; 1 if `d` lies strictly inside the circle through `a`, `b`, `c`
+// `a`, `b`, `c` must be in counterclockwise order
+// integer coordinates are exact in the range of `InCircleInteger`
+template<typename Tp>
+int InCircle(const Point<Tp, 2>& a, const Point<Tp, 2>& b,
+             const Point<Tp, 2>& c, const Point<Tp, 2>& d)
+{
+    Tp p[6] = {a.x(), a.y(), b.x(), b.y(), c.x(), c.y()};
+    Tp q[6] = {d.x(), d.y(), d.x(), d.y(), d.x(), d.y()};
+    return detail::PredicateSign<detail::InCircleDet>(p, q);
+}
+
+// returns: -1, 0, 1; 1 if `d` lies on the side of plane `a`, `b`, `c`,
+// where (b - a) x (c - a) points; tetrahedron `a`, `b`, `c`, `d` is positive in this case
+// integer coordinates are exact for |coordinate| <= `MaxOrientation3Coordinate()`
+template<typename Tp>
+int Orientation(const Point<Tp, 3>& a, const Point<Tp, 3>& b,
+                const Point<Tp, 3>& c, const Point<Tp, 3>& d)
+{
+    Tp p[9] = {b.x(), b.y(), b.z(), c.x(), c.y(), c.z(), d.x(), d.y(), d.z()};
+    Tp q[9] = {a.x(), a.y(), a.z(), a.x(), a.y(), a.z(), a.x(), a.y(), a.z()};
+    return detail::PredicateSign<detail::Orientation3Det>(p, q);
+}
+
+// returns true if `a`, `b`, `c` lie on one line
+// integer coordinates are exact for |coordinate| <= `MaxOrientation3Coordinate()`
+template<typename Tp>
+bool Collinear(const Point<Tp, 3>& a, const Point<Tp, 3>& b, const Point<Tp, 3>& c) {
+    // projections to the planes yz, zx and xy are degenerate
+    for (size_t axis = 0; axis < 3; ++axis) {
+        size_t u = (axis + 1) % 3;
+        size_t v = (axis + 2) % 3;
+        Tp p[4] = {b.Get(u), b.Get(v), c.Get(u), c.Get(v)};
+        Tp q[4] = {a.Get(u), a.Get(v), a.Get(u), a.Get(v)};
+        if (detail::PredicateSign<detail::Projection2Det>(p, q) != 0)
+            return false;
+    }
+    return true;
+}
+
+// returns: -1, 0, 1; 1 if `e` lies strictly inside the sphere through `a`, `b`, `c`, `d`
+// tetrahedron `a`, `b`, `c`, `d` must be positive
+// integer coordinates are exact for |coordinate| <= `MaxInSphereCoordinate()`
+template<typename Tp>
+int InSphere(const Point<Tp, 3>& a, const Point<Tp, 3>& b, const Point<Tp, 3>& c,
+             const Point<Tp, 3>& d, const Point<Tp, 3>& e)
+{
+    Tp p[12] = {a.x(), a.y(), a.z(), b.x(), b.y(), b.z(), c.x(), c.y(), c.z(), d.x(), d.y(), d.z()};
+    Tp q[12] = {e.x(), e.y(), e.z(), e.x(), e.y(), e.z(), e.x(), e.y(), e.z(), e.x(), e.y(), e.z()};
+    return -detail::PredicateSign<detail::InSphereDet>(p, q);
+}
+
+} // namespace geometry
+
+#endif // PREDICATES_H
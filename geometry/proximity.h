@@ -0,0 +1,266 @@
+#ifndef PROXIMITY_H
+#define PROXIMITY_H
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <limits>
+#include <utility>
+#include <cmath>
+#include <cstdint>
+#include <cassert>
+#include "point.h"
+#include "predicates.h"
+#include "parallel.h"
+
+namespace geometry {
+
+// pairs of close points, all distances are `Distance2`, so radii are squared
+// `points` must outlive the search
+template<typename Tp>
+class ProximitySearch {
+public:
+    typedef Point<Tp> Pnt;
+    typedef typename DistanceType<Tp>::type Dist;
+
+    static const size_t NONE = static_cast<size_t>(-1);
+
+public:
+    explicit ProximitySearch(const std::vector<Pnt>& points)
+        : points_(points)
+    {}
+
+    // divide and conquer (Shamos, Hoey): points are sorted by x once, halves are solved
+    // recursively and merged by y, so around the split only a strip as wide as the best
+    // distance is checked, each point against at most 7 next ones
+    // returns (NONE, NONE) for less than 2 points
+    std::pair<size_t, size_t> ClosestPair(size_t threads = 1) {
+        if (points_.size() < 2)
+            return std::make_pair(NONE, NONE);
+
+        // points are copied with their ids, so the recursion reads them sequentially
+        items_.resize(points_.size());
+        buffer_.resize(points_.size());
+        for (size_t i = 0; i < items_.size(); ++i)
+            items_[i] = Item{points_[i], i};
+        ParallelSort(items_.begin(), items_.end(), [] (const Item& a, const Item& b) {
+            return a.p.x() < b.p.x();
+        }, threads);
+
+        size_t parallel_depth = 0;
+        while ((size_t(1) << parallel_depth) < ThreadsCount(threads, points_.size() / 1024))
+            ++parallel_depth;
+
+        Pair best = Closest(0, points_.size(), 0, parallel_depth);
+        return std::make_pair(std::min(best.a, best.b), std::max(best.a, best.b));
+    }
+
+    // appends pairs (i, j), i < j, with `Distance2` <= `radius2` to `res`
+    // points are bucketed by a grid of cells not smaller than the radius, so only points
+    // of the same and of the 8 neighbour cells are compared; cells are sorted instead of
+    // hashed, then the cells (x + 1, y - 1), ..., (x + 1, y + 1) are consecutive
+    // chunks of cells are taken by threads, the order of pairs doesn't depend on them
+    void AllPairsWithin(Dist radius2, std::vector<std::pair<size_t, size_t>>& res,
+                        size_t threads = 1) {
+        assert(radius2 >= 0);
+        if (points_.empty())
+            return;
+
+        BuildGrid(std::sqrt(static_cast<double>(radius2)), threads);
+
+        size_t count = starts_.size() - 1;
+        size_t chunks = ThreadsCount(threads, count);
+        std::vector<std::vector<std::pair<size_t, size_t>>> chunk_res(chunks);
+        ParallelChunks(count, chunks, [&] (size_t chunk, size_t begin, size_t end) {
+            for (size_t c = begin; c < end; ++c)
+                CellPairs(c, radius2, chunk_res[chunk]);
+        });
+
+        for (const auto& chunk: chunk_res)
+            res.insert(res.end(), chunk.begin(), chunk.end());
+    }
+
+private:
+    struct Pair {
+        Dist dist;
+        size_t a;
+        size_t b;
+    };
+
+    struct Item {
+        Pnt p;
+        size_t id;
+    };
+
+    struct Cell {
+        int64_t x;
+        int64_t y;
+        size_t id;
+
+        bool operator<(const Cell& oth) const {
+            return x < oth.x || (x == oth.x && y < oth.y);
+        }
+    };
+
+    static Dist Square(Dist d) {
+        return d * d;
+    }
+
+    static void Check(const Item& a, const Item& b, Pair& best) {
+        Dist dist = a.p.template Distance2<Dist>(b.p);
+        if (dist < best.dist)
+            best = Pair{dist, a.id, b.id};
+    }
+
+    // items_ in [begin, end) are sorted by x before and by y after the call
+    Pair Closest(size_t begin, size_t end, size_t depth, size_t parallel_depth) {
+        auto by_y = [] (const Item& a, const Item& b) {
+            return a.p.y() < b.p.y();
+        };
+
+        Pair best{std::numeric_limits<Dist>::max(), NONE, NONE};
+        if (end - begin <= 3) {
+            for (size_t i = begin; i < end; ++i)
+                for (size_t j = i + 1; j < end; ++j)
+                    Check(items_[i], items_[j], best);
+            std::sort(items_.begin() + begin, items_.begin() + end, by_y);
+            return best;
+        }
+
+        size_t mid = begin + (end - begin) / 2;
+        Dist split = items_[mid].p.x();
+
+        Pair left, right;
+        if (depth < parallel_depth) {
+            std::thread worker([&] {
+                left = Closest(begin, mid, depth + 1, parallel_depth);
+            });
+            right = Closest(mid, end, depth + 1, parallel_depth);
+            worker.join();
+        } else {
+            left = Closest(begin, mid, depth + 1, parallel_depth);
+            right = Closest(mid, end, depth + 1, parallel_depth);
+        }
+        best = left.dist <= right.dist ? left : right;
+
+        std::merge(items_.begin() + begin, items_.begin() + mid, items_.begin() + mid,
+                   items_.begin() + end, buffer_.begin() + begin, by_y);
+        std::copy(buffer_.begin() + begin, buffer_.begin() + end, items_.begin() + begin);
+
+        // the strip is kept in the same range of buffer_, ranges of threads don't overlap
+        size_t strip = begin;
+        for (size_t i = begin; i < end; ++i) {
+            if (Square(items_[i].p.x() - split) < best.dist)
+                buffer_[strip++] = items_[i];
+        }
+
+        for (size_t i = begin; i < strip; ++i) {
+            for (size_t j = i + 1; j < strip; ++j) {
+                if (Square(static_cast<Dist>(buffer_[j].p.y()) - buffer_[i].p.y()) >= best.dist)
+                    break;
+                Check(buffer_[i], buffer_[j], best);
+            }
+        }
+        return best;
+    }
+
+    // cells of `size` at least `radius`, with a margin for rounding of the cell coordinates;
+    // cells_ are sorted, points of cell c are cells_[starts_[c]], ..., cells_[starts_[c + 1] - 1]
+    void BuildGrid(double radius, size_t threads) {
+        double min_x = points_[0].x(), max_x = min_x;
+        double min_y = points_[0].y(), max_y = min_y;
+        for (const Pnt& p: points_) {
+            min_x = std::min<double>(min_x, p.x());
+            max_x = std::max<double>(max_x, p.x());
+            min_y = std::min<double>(min_y, p.y());
+            max_y = std::max<double>(max_y, p.y());
+        }
+
+        double scale = std::max(std::max(std::abs(min_x), std::abs(max_x)),
+                                std::max(std::abs(min_y), std::abs(max_y)));
+        scale = std::max(scale, std::max(max_x - min_x, max_y - min_y));
+        double size = radius * (1 + 1e-12) + scale * 1e-15;
+        if (!(size > 0))
+            size = 1;
+
+        cells_.resize(points_.size());
+        ParallelFor(points_.size(), threads, [&] (size_t i) {
+            cells_[i].x = static_cast<int64_t>((points_[i].x() - min_x) / size);
+            cells_[i].y = static_cast<int64_t>((points_[i].y() - min_y) / size);
+            cells_[i].id = i;
+        });
+        ParallelSort(cells_.begin(), cells_.end(), [] (const Cell& a, const Cell& b) {
+            return a < b;
+        }, threads);
+
+        starts_.clear();
+        for (size_t i = 0; i < cells_.size(); ++i) {
+            if (i == 0 || cells_[i - 1] < cells_[i])
+                starts_.push_back(i);
+        }
+        starts_.push_back(cells_.size());
+    }
+
+    // pairs inside cell `c` and with the cells (x, y + 1), (x + 1, y - 1), ..., (x + 1, y + 1)
+    void CellPairs(size_t c, Dist radius2, std::vector<std::pair<size_t, size_t>>& res) const {
+        size_t begin = starts_[c];
+        size_t end = starts_[c + 1];
+        for (size_t i = begin; i < end; ++i)
+            for (size_t j = i + 1; j < end; ++j)
+                Report(cells_[i].id, cells_[j].id, radius2, res);
+
+        const Cell& cell = cells_[begin];
+        if (c + 2 < starts_.size()) {
+            const Cell& up = cells_[end];
+            if (up.x == cell.x && up.y == cell.y + 1)
+                Neighbours(begin, end, end, starts_[c + 2], radius2, res);
+        }
+
+        Cell from{cell.x + 1, cell.y - 1, 0};
+        Cell to{cell.x + 1, cell.y + 2, 0};
+        size_t first = std::lower_bound(cells_.begin() + end, cells_.end(), from) - cells_.begin();
+        size_t last = std::lower_bound(cells_.begin() + first, cells_.end(), to) - cells_.begin();
+        Neighbours(begin, end, first, last, radius2, res);
+    }
+
+    void Neighbours(size_t begin, size_t end, size_t first, size_t last, Dist radius2,
+                    std::vector<std::pair<size_t, size_t>>& res) const {
+        for (size_t i = begin; i < end; ++i)
+            for (size_t j = first; j < last; ++j)
+                Report(cells_[i].id, cells_[j].id, radius2, res);
+    }
+
+    void Report(size_t a, size_t b, Dist radius2, std::vector<std::pair<size_t, size_t>>& res) const {
+        if (points_[a].template Distance2<Dist>(points_[b]) <= radius2)
+            res.push_back(std::make_pair(std::min(a, b), std::max(a, b)));
+    }
+
+private:
+    const std::vector<Pnt>& points_;
+    std::vector<Item> items_;
+    std::vector<Item> buffer_;
+    std::vector<Cell> cells_;
+    std::vector<size_t> starts_;
+};
+
+template<typename Tp>
+const size_t ProximitySearch<Tp>::NONE;
+
+// returns indices i < j of the closest pair of points
+template<typename Tp>
+std::pair<size_t, size_t> ClosestPair(const std::vector<Point<Tp>>& points, size_t threads = 1) {
+    return ProximitySearch<Tp>(points).ClosestPair(threads);
+}
+
+// returns all pairs (i, j), i < j, of points with `Distance2` <= `radius2`
+template<typename Tp>
+std::vector<std::pair<size_t, size_t>> AllPairsWithin(const std::vector<Point<Tp>>& points,
+                                                      typename DistanceType<Tp>::type radius2,
+                                                      size_t threads = 1) {
+    std::vector<std::pair<size_t, size_t>> res;
+    ProximitySearch<Tp>(points).AllPairsWithin(radius2, res, threads);
+    return res;
+}
+
+} // namespace geometry
+
+#endif // PROXIMITY_H
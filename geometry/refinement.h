@@ -0,0 +1,254 @@
+#ifndef REFINEMENT_H
+#define REFINEMENT_H
+#include <vector>
+#include <queue>
+#include <cmath>
+#include <cassert>
+#include <type_traits>
+#include "point.h"
+#include "vector.h"
+#include "circle.h"
+#include "triangle_mesh.h"
+#include "delaunay.h"
+
+namespace geometry {
+
+struct RefineParams {
+    explicit RefineParams(double min_angle = 20, double max_area = 0, size_t max_steiner = 10000000)
+        : min_angle(min_angle)
+        , max_area(max_area)
+        , max_steiner(max_steiner)
+    {}
+
+    // in degrees, refinement is guaranteed to terminate for `min_angle` <= 20.7
+    // if the hull has no angles sharper than 60 degrees
+    double min_angle;
+    // 0 means unbounded
+    double max_area;
+    // upper bound on count of inserted points, protects from sharp hull angles
+    size_t max_steiner;
+};
+
+// Ruppert's Delaunay refinement, the domain is the convex hull of the triangulation
+// bad triangles are split by their circumcenters (the worst triangle first),
+// circumcenters encroaching on hull edges split these edges instead
+// returns count of inserted Steiner points
+template<typename Tp, typename Index>
+size_t Refine(Delaunay<Tp, Index>& mesh, const RefineParams& params = RefineParams()) {
+    static_assert(std::is_floating_point<Tp>::value,
+            "Steiner points require floating point coordinates");
+
+    typedef Point<Tp, 2> Pnt;
+    typedef Vector<Tp, 2> Vec;
+    typedef TriangleMesh<Index> Mesh;
+    const Index NONE = Mesh::NONE;
+    const Mesh& topology = mesh.GetMesh();
+
+    struct BadTriangle {
+        BadTriangle(double priority, Index t, Index a, Index b, Index c)
+            : priority(priority)
+            , t(t)
+            , a(a)
+            , b(b)
+            , c(c)
+        {}
+
+        bool operator<(const BadTriangle& oth) const {
+            return priority < oth.priority;
+        }
+
+        double priority;
+        Index t;
+        Index a, b, c;
+    };
+
+    // circumradius / shortest edge = 1 / (2 sin(min angle))
+    const double pi = std::acos(-1.0);
+    double max_ratio = 1.0 / (2 * std::sin(params.min_angle * pi / 180));
+    double max_ratio2 = max_ratio * max_ratio;
+
+    std::priority_queue<BadTriangle> queue;
+
+    // returns priority > 1 for bad triangles
+    auto quality = [&] (Index t) -> double {
+        const Pnt& a = mesh.GetPoint(topology.Vertex(t, 0));
+        const Pnt& b = mesh.GetPoint(topology.Vertex(t, 1));
+        const Pnt& c = mesh.GetPoint(topology.Vertex(t, 2));
+
+        double ab = a.template Distance2<double>(b);
+        double bc = b.template Distance2<double>(c);
+        double ca = c.template Distance2<double>(a);
+        double area = std::abs(Vec(a, b).template Cross<double>(Vec(a, c))) / 2;
+        if (area == 0)
+            return 0;
+
+        double radius = Circumradius(a, b, c);
+        double radius2 = radius * radius;
+        double shortest2 = std::min(ab, std::min(bc, ca));
+
+        double res = radius2 / shortest2 / max_ratio2;
+        if (params.max_area > 0)
+            res = std::max(res, area / params.max_area);
+        return res;
+    };
+
+    auto push = [&] (Index t) {
+        double priority = quality(t);
+        if (priority > 1)
+            queue.push(BadTriangle(priority, t, topology.Vertex(t, 0),
+                                   topology.Vertex(t, 1), topology.Vertex(t, 2)));
+    };
+
+    // triangle ids are reused by flips
+    auto alive = [&] (const BadTriangle& bad) -> bool {
+        for (size_t k = 0; k < 3; ++k) {
+            if (topology.Vertex(bad.t, k) == bad.a &&
+                topology.Vertex(bad.t, (k + 1) % 3) == bad.b &&
+                topology.Vertex(bad.t, (k + 2) % 3) == bad.c)
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // returns false if `p` is an existing vertex, so nothing changes
+    size_t inserted = 0;
+    auto insert = [&] (const Pnt& p) -> bool {
+        size_t count = mesh.PointsCount();
+        Index v = mesh.Insert(p);
+        if (v < count)
+            return false;
+
+        for (Index h: topology.OutgoingEdges(v))
+            push(h / 3);
+        ++inserted;
+        return true;
+    };
+
+    // `p` encroaches on the hull edge, if it lies inside its diametral circle
+    auto encroached = [&] (Index h, const Pnt& p) -> bool {
+        const Pnt& a = mesh.GetPoint(topology.Origin(h));
+        const Pnt& b = mesh.GetPoint(topology.Target(h));
+        return Vec(p, a).DotProduct(Vec(p, b)) < 0;
+    };
+
+    // the midpoint of an edge a few ulps long is one of its endpoints
+    auto split = [&] (Index h) -> bool {
+        const Pnt& a = mesh.GetPoint(topology.Origin(h));
+        const Pnt& b = mesh.GetPoint(topology.Target(h));
+        return insert(Pnt((a.x() + b.x()) / 2, (a.y() + b.y()) / 2));
+    };
+
+    // the hull edge, which the ray from the centroid of `t` to `p` leaves the mesh through,
+    // its diametral circle is encroached by the circumcircle of `t`, if `p` is its center
+    // NONE if the ray doesn't leave the mesh or runs along edges
+    auto crossed = [&] (Index t, const Pnt& p) -> Index {
+        const Pnt& a = mesh.GetPoint(topology.Vertex(t, 0));
+        const Pnt& b = mesh.GetPoint(topology.Vertex(t, 1));
+        const Pnt& c = mesh.GetPoint(topology.Vertex(t, 2));
+        Pnt from((a.x() + b.x() + c.x()) / 3, (a.y() + b.y() + c.y()) / 3);
+
+        // the ray leaves a triangle through the edge with the origin right of it
+        // and the target left of it
+        Index came = NONE;
+        for (size_t steps = 0; steps <= topology.TrianglesCount(); ++steps) {
+            Index exit = NONE;
+            for (Index e = 3 * t; e < 3 * t + 3 && exit == NONE; ++e) {
+                const Pnt& origin = mesh.GetPoint(topology.Origin(e));
+                const Pnt& target = mesh.GetPoint(topology.Target(e));
+                if (e != came && Orientation(origin, target, p) < 0 &&
+                    Orientation(from, p, origin) <= 0 && Orientation(from, p, target) > 0)
+                {
+                    exit = e;
+                }
+            }
+
+            if (exit == NONE || topology.Twin(exit) == NONE)
+                return exit;
+            came = topology.Twin(exit);
+            t = came / 3;
+        }
+        return NONE;
+    };
+
+    // relative to `a`, so it doesn't cancel for small triangles far from the origin
+    if (mesh.TrianglesCount() == 0)
+        return 0;
+
+    for (Index t = 0; t < mesh.TrianglesCount(); ++t)
+        push(t);
+
+    std::vector<Index> cavity;
+    std::vector<Index> visited;
+
+    while (!queue.empty() && inserted < params.max_steiner) {
+        BadTriangle bad = queue.top();
+        queue.pop();
+        if (!alive(bad))
+            continue;
+
+        Point<double> exact_center = Circumcenter(mesh.GetPoint(bad.a), mesh.GetPoint(bad.b), mesh.GetPoint(bad.c));
+        if (!std::isfinite(exact_center.x()) || !std::isfinite(exact_center.y()))
+            continue;
+        Pnt center(static_cast<Tp>(exact_center.x()), static_cast<Tp>(exact_center.y()));
+
+        Index h;
+        auto type = mesh.Locate(center, h);
+        if (type == Delaunay<Tp, Index>::ON_VERTEX)
+            continue;
+
+        // triangles, which can't be split, are dropped
+        if (type == Delaunay<Tp, Index>::OUT_OF_HULL) {
+            Index edge = crossed(bad.t, center);
+            if (edge != NONE && split(edge) && alive(bad))
+                queue.push(bad);
+            continue;
+        }
+
+        // hull edges of the cavity of `center`, which it encroaches on
+        Index encroached_edge = NONE;
+        cavity.assign(1, h / 3);
+        visited.assign(1, h / 3);
+        while (!cavity.empty() && encroached_edge == NONE) {
+            Index t = cavity.back();
+            cavity.pop_back();
+
+            for (Index e = 3 * t; e < 3 * t + 3; ++e) {
+                Index twin = topology.Twin(e);
+                if (twin == NONE) {
+                    if (encroached(e, center)) {
+                        encroached_edge = e;
+                        break;
+                    }
+                    continue;
+                }
+
+                Index s = twin / 3;
+                if (std::find(visited.begin(), visited.end(), s) != visited.end())
+                    continue;
+
+                if (InCircle(mesh.GetPoint(topology.Vertex(s, 0)),
+                             mesh.GetPoint(topology.Vertex(s, 1)),
+                             mesh.GetPoint(topology.Vertex(s, 2)), center) > 0)
+                {
+                    visited.push_back(s);
+                    cavity.push_back(s);
+                }
+            }
+        }
+
+        if (encroached_edge != NONE) {
+            if (split(encroached_edge) && alive(bad))
+                queue.push(bad);
+        } else {
+            insert(center);
+        }
+    }
+
+    return inserted;
+}
+
+} // namespace geometry
+
+#endif // REFINEMENT_H
@@ -6,8 +6,11 @@
 #include <functional>
 #include <cmath>
 #include <cassert>
+#include <algorithm>
+#include <set>
 #include "point.h"
 #include "vector.h"
+#include "predicates.h"
 
 namespace geometry {
 
@@ -18,73 +21,203 @@ private:
     typedef Point<Tp, dim> Pnt;
 
 public: 
-    Segment() {}
+    // only the endpoints are stored, directions are computed on demand
+    constexpr Segment()
+        : p1_()
+        , p2_()
+    {}
 
-    Segment (const Pnt& p1, const Pnt& p2) 
+    constexpr Segment(const Pnt& p1, const Pnt& p2)
         : p1_(p1)
         , p2_(p2)
-        , v_(p1, p2)
-        , v_rev_(p2, p1)
     {}
 
     void Reorder() {
-        if (p2_ < p1_) {
+        if (p2_ < p1_)
             std::swap(p1_, p2_);
-            std::swap(v_, v_rev_);
-        }
+    }
+
+    Vec Direction() const {
+        return Vec(p1_, p2_);
     }
 
     bool Inside(const Pnt& p) const {
-        Vec p1_p(p1_, p);
-        Vec p2_p(p2_, p);
-        if (v_.Rotate(p1_p) == 0) 
-            return v_.template DotProductSign<long long>(p1_p) * v_rev_.template DotProductSign<long long>(p2_p) >= 0;
-        else
+        // collinear points go along the line in lexicographic order
+        if (Orientation(p1_, p2_, p) != 0)
             return false;
+        return !(p < std::min(p1_, p2_)) && !(std::max(p1_, p2_) < p);
     }
 
     bool Intersected(const Segment<Tp>& oth) const {
-        int f1 = v_.Rotate(Vec(p1_, oth.p1_));
-        int f2 = v_.Rotate(Vec(p1_, oth.p2_));
-        int f3 = oth.v_.Rotate(Vec(oth.p1_, p1_));
-        int f4 = oth.v_.Rotate(Vec(oth.p1_, p2_));
+        int f1 = Orientation(p1_, p2_, oth.p1_);
+        int f2 = Orientation(p1_, p2_, oth.p2_);
+        int f3 = Orientation(oth.p1_, oth.p2_, p1_);
+        int f4 = Orientation(oth.p1_, oth.p2_, p2_);
         if (f1 == 0 && f2 == 0 && f3 == 0 && f4 == 0)
             return oth.Inside(p1_) || oth.Inside(p2_) || Inside(oth.p1_) || Inside(oth.p2_);
         else 
             return f1 * f2 <= 0 && f3 * f4 <= 0;
     }
 
+    // collinear segments sharing more than one point, segments must not be degenerate
+    bool Overlapped(const Segment<Tp>& oth) const {
+        if (Orientation(p1_, p2_, oth.p1_) != 0 || Orientation(p1_, p2_, oth.p2_) != 0)
+            return false;
+
+        // the common line isn't vertical, if the segment isn't
+        size_t axis = p1_.x() != p2_.x() ? 0 : 1;
+        Tp lo = std::min(p1_.Get(axis), p2_.Get(axis));
+        Tp hi = std::max(p1_.Get(axis), p2_.Get(axis));
+        Tp oth_lo = std::min(oth.p1_.Get(axis), oth.p2_.Get(axis));
+        Tp oth_hi = std::max(oth.p1_.Get(axis), oth.p2_.Get(axis));
+        return std::max(lo, oth_lo) < std::min(hi, oth_hi);
+    }
+
     Pnt Middle() const {
-        return p1_ + Pnt(v_) / 2;
+        return p1_ + Pnt(Direction()) / 2;
     }
 
 private:
     Pnt p1_, p2_;
-    Vec v_, v_rev_;
 
 private:
 
     template<typename, size_t>
     friend class Point;
 
-    template<typename U>
-    friend std::istream& operator>>(std::istream& in, Segment<U>& segment) {
-        in >> segment.p1_ >> segment.p2_;
-        segment.v_ = Vector<U>(segment.p1_, segment.p2_);
-        segment.v_rev_ = Vector<U>(segment.p2_, segment.p1_);
-
-        return in;
+    friend std::istream& operator>>(std::istream& in, Segment<Tp, dim>& segment) {
+        return in >> segment.p1_ >> segment.p2_;
     }
 
-    template<typename U>
-    friend std::ostream& operator<<(std::ostream& out, const Segment<U>& segment) {
+    friend std::ostream& operator<<(std::ostream& out, const Segment<Tp, dim>& segment) {
         return out << "SEGMENT: " << segment.p1_ << " " << segment.p2_;
     }
 
-    template<typename U>
-    friend std::pair<int, int> FindIntersection(std::vector<Segment<U>>& segments);
+    template<typename U, typename Adjacent>
+    friend std::pair<int, int> FindIntersection(std::vector<Segment<U>>& segments, Adjacent adjacent);
 };
 
+// order of segments in the status of a sweep over x: 1 if segment (s1, s2) is above
+// segment (t1, t2) at `s1`, segments go from the lower left endpoint, `s1` isn't before `t1`
+// segments through the same point are ordered by slope, a vertical segment
+// is at its lower end and has the greatest slope
+// the comparison is exact, so the order is consistent while segments don't cross
+template<typename Tp>
+int SweepSide(const Point<Tp>& s1, const Point<Tp>& s2, const Point<Tp>& t1, const Point<Tp>& t2) {
+    bool vertical = s1.x() == s2.x();
+    if (t1.x() == t2.x()) {
+        if (s1.y() != t1.y())
+            return s1.y() > t1.y() ? 1 : -1;
+        return vertical ? 0 : -1;
+    }
+
+    int side = Orientation(t1, t2, s1);
+    if (side != 0 || vertical)
+        return side != 0 ? side : 1;
+    return Orientation(t1, t2, s2);
+}
+
+// the same for any order of the left endpoints
+template<typename Tp>
+int SweepOrder(const Point<Tp>& s1, const Point<Tp>& s2, const Point<Tp>& t1, const Point<Tp>& t2) {
+    return t1 < s1 ? SweepSide(s1, s2, t1, t2) : -SweepSide(t1, t2, s1, s2);
+}
+
+// sweep line (Shamos, Hoey), returns ids of two intersecting segments or {-1, -1}
+// segments i, j with `adjacent(i, j)` share an endpoint, they intersect only if they overlap
+// segments are reordered, so that p1_ is the lower left endpoint
+template<typename Tp, typename Adjacent>
+std::pair<int, int> FindIntersection(std::vector<Segment<Tp>>& segments, Adjacent adjacent) {
+    using namespace std;
+
+    struct Event {
+        Event(Tp x, int ev, int id)
+            : x(x)
+            , ev(ev)
+            , id(id)
+        {}
+
+        bool operator<(const Event& oth) const {
+            return (x < oth.x) || (x == oth.x && ev > oth.ev);
+        }
+
+        Tp x;
+        int ev;
+        int id;
+    };
+
+    vector<Event> events;
+    for (size_t i = 0; i < segments.size(); ++i) {
+        Segment<Tp>& s = segments[i];
+        s.Reorder();
+        events.push_back(Event(s.p1_.x(), 1, i));
+        events.push_back(Event(s.p2_.x(), -1, i));
+    }
+    sort(events.begin(), events.end());
+
+    struct Seg {
+        Seg(Segment<Tp>* s, int id)
+            : s(s)
+            , id(id)
+        {}
+
+        bool operator<(const Seg& seg) const {
+            if (id == seg.id)
+                return false;
+
+            int side = SweepOrder(s->p1_, s->p2_, seg.s->p1_, seg.s->p2_);
+            return side < 0 || (side == 0 && id < seg.id);
+        }
+
+        Segment<Tp>* s;
+        int id;
+    };
+
+    auto crossed = [&segments, &adjacent] (int i, int j) {
+        if (adjacent(i, j))
+            return segments[i].Overlapped(segments[j]);
+        return segments[i].Intersected(segments[j]);
+    };
+
+    set<Seg> s;
+    vector<typename set<Seg>::iterator> where(segments.size());
+
+    for (const auto& e: events) {
+        if (e.ev == 1) {
+            auto& seg = segments[e.id];
+
+            auto n = s.lower_bound(Seg(&seg, e.id));
+            if (n != s.end() && crossed(e.id, n->id))
+                return {e.id, n->id};
+
+            if (n != s.begin()) {
+                auto p = prev(n);
+                if (crossed(e.id, p->id))
+                    return {e.id, p->id};
+            }
+
+            where[e.id] = s.insert(n, Seg(&seg, e.id));
+        } else {
+            assert(e.ev == -1);
+            auto n = s.erase(where[e.id]);
+            if (n != s.end() && n != s.begin()) {
+                auto p = prev(n);
+                if (crossed(n->id, p->id))
+                    return {n->id, p->id};
+            }
+        }
+    }
+
+    return {-1, -1};
+}
+
+template<typename Tp>
+std::pair<int, int> FindIntersection(std::vector<Segment<Tp>>& segments) {
+    return FindIntersection(segments, [] (int, int) {
+        return false;
+    });
+}
+
 } // namespace geometry
 
 #endif // SEGMENT_H
@@ -0,0 +1,338 @@
+#ifndef SIMPLIFICATION_H
+#define SIMPLIFICATION_H
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <limits>
+#include <tuple>
+#include <cmath>
+#include <cassert>
+#include "point.h"
+#include "polygon.h"
+#include "predicates.h"
+#include "parallel.h"
+
+namespace geometry {
+
+enum SimplificationType : int {
+    DOUGLAS_PEUCKER, VISVALINGAM
+};
+
+// removes vertices of a simple polygon so that every removed vertex is within `tolerance`
+// of the edge which replaced it, i.e. the boundaries are within `tolerance` (Hausdorff)
+// shortcuts crossing the rest of the boundary are split again, so the result stays simple
+template<typename Tp>
+class Simplifier {
+private:
+    typedef Point<Tp> Pnt;
+    typedef typename PredicateType<Tp>::type T;
+
+public:
+    // recursive splitting at the farthest vertex (Douglas, Peucker)
+    Polygon<Tp> DouglasPeucker(const Polygon<Tp>& polygon, double tolerance) {
+        if (!Init(polygon, tolerance))
+            return polygon;
+
+        kept_.assign(n_, 0);
+        size_t far = 0;
+        T best = -1;
+        for (size_t k = 1; k < n_; ++k) {
+            T d = points_[0].template Distance2<T>(points_[k]);
+            if (d > best) {
+                best = d;
+                far = k;
+            }
+        }
+
+        kept_[0] = kept_[far] = 1;
+        Refine(0, far);
+        Refine(far, n_);
+
+        if (std::count(kept_.begin(), kept_.end(), 1) < 3) {
+            std::pair<size_t, double> first = Farthest(0, far);
+            std::pair<size_t, double> second = Farthest(far, n_);
+            kept_[(first.second > second.second ? first.first : second.first) % n_] = 1;
+        }
+
+        return Finish();
+    }
+
+    // removes vertices in order of area of the triangle with their neighbours (Visvalingam, Whyatt)
+    // while the area is less than `max_area` and the removed vertices stay within `tolerance`
+    Polygon<Tp> Visvalingam(const Polygon<Tp>& polygon, double tolerance,
+                            double max_area = std::numeric_limits<double>::infinity()) {
+        if (!Init(polygon, tolerance))
+            return polygon;
+
+        struct Item {
+            double area;
+            size_t id;
+            size_t stamp;
+
+            bool operator<(const Item& oth) const {
+                return area > oth.area;
+            }
+        };
+
+        kept_.assign(n_, 1);
+        prev_.resize(n_);
+        next_.resize(n_);
+        stamp_.assign(n_, 0);
+        std::vector<double> area(n_);
+        std::priority_queue<Item> heap;
+        for (size_t i = 0; i < n_; ++i) {
+            prev_[i] = (i + n_ - 1) % n_;
+            next_[i] = (i + 1) % n_;
+            area[i] = Area(prev_[i], i, next_[i]);
+            heap.push(Item{area[i], i, 0});
+        }
+
+        size_t left = n_;
+        while (!heap.empty() && left > 3) {
+            Item top = heap.top();
+            heap.pop();
+            size_t v = top.id;
+            if (!kept_[v] || top.stamp != stamp_[v])
+                continue;
+            if (top.area >= max_area)
+                break;
+
+            // a blocked vertex waits until one of its neighbours is removed
+            size_t p = prev_[v];
+            size_t q = next_[v];
+            if (Farthest(p, p < q ? q : q + n_).second > tolerance_)
+                continue;
+
+            kept_[v] = 0;
+            --left;
+            next_[p] = q;
+            prev_[q] = p;
+            for (size_t u: {p, q}) {
+                // the effective area never decreases, so vertices leave in order of it
+                area[u] = std::max(Area(prev_[u], u, next_[u]), top.area);
+                heap.push(Item{area[u], u, ++stamp_[u]});
+            }
+        }
+
+        return Finish();
+    }
+
+private:
+    bool Init(const Polygon<Tp>& polygon, double tolerance) {
+        n_ = polygon.Size();
+        tolerance_ = tolerance;
+        if (n_ <= 3)
+            return false;
+
+        points_.resize(n_);
+        for (size_t i = 0; i < n_; ++i)
+            points_[i] = polygon[i];
+        return true;
+    }
+
+    const Pnt& P(size_t i) const {
+        return points_[i < n_ ? i : i - n_];
+    }
+
+    double Area(size_t a, size_t b, size_t c) const {
+        return std::abs(static_cast<double>(Orientation2<T>(P(a), P(b), P(c)))) / 2;
+    }
+
+    static double Distance(const Pnt& p, const Pnt& a, const Pnt& b) {
+        double dx = static_cast<double>(b.x()) - a.x();
+        double dy = static_cast<double>(b.y()) - a.y();
+        double px = static_cast<double>(p.x()) - a.x();
+        double py = static_cast<double>(p.y()) - a.y();
+        double len = dx * dx + dy * dy;
+        double t = len > 0 ? std::max(0.0, std::min(1.0, (px * dx + py * dy) / len)) : 0;
+        px -= t * dx;
+        py -= t * dy;
+        return sqrt(px * px + py * py);
+    }
+
+    // the farthest vertex of i + 1, ..., j - 1 from the segment (i, j); indices may exceed n
+    std::pair<size_t, double> Farthest(size_t i, size_t j) const {
+        std::pair<size_t, double> res(i + 1, -1);
+        for (size_t k = i + 1; k < j; ++k) {
+            double d = Distance(P(k), P(i), P(j));
+            if (d > res.second)
+                res = std::make_pair(k, d);
+        }
+        return res;
+    }
+
+    // keeps vertices between i and j until every edge is within tolerance
+    void Refine(size_t i, size_t j) {
+        stack_.assign(1, std::make_pair(i, j));
+        while (!stack_.empty()) {
+            std::tie(i, j) = stack_.back();
+            stack_.pop_back();
+            if (j - i < 2)
+                continue;
+
+            std::pair<size_t, double> far = Farthest(i, j);
+            if (far.second > tolerance_) {
+                kept_[far.first % n_] = 1;
+                stack_.push_back(std::make_pair(i, far.first));
+                stack_.push_back(std::make_pair(far.first, j));
+            }
+        }
+    }
+
+    // splits shortcuts until no two edges of the result cross
+    Polygon<Tp> Finish() {
+        for (;;) {
+            ids_.clear();
+            for (size_t i = 0; i < n_; ++i)
+                if (kept_[i])
+                    ids_.push_back(i);
+
+            bool changed = false;
+            for (size_t e: Conflicts()) {
+                size_t i = ids_[e];
+                size_t j = e + 1 < ids_.size() ? ids_[e + 1] : ids_[0] + n_;
+                if (j - i < 2)
+                    continue;
+
+                size_t k = Farthest(i, j).first;
+                kept_[k % n_] = 1;
+                Refine(i, k);
+                Refine(k, j);
+                changed = true;
+            }
+
+            if (!changed)
+                break;
+        }
+
+        std::vector<Pnt> res;
+        res.reserve(ids_.size());
+        for (size_t i: ids_)
+            res.push_back(points_[i]);
+        return Polygon<Tp>(std::move(res));
+    }
+
+    bool OnSegment(const Pnt& p, const Pnt& a, const Pnt& b) const {
+        return std::min(a.x(), b.x()) <= p.x() && p.x() <= std::max(a.x(), b.x())
+            && std::min(a.y(), b.y()) <= p.y() && p.y() <= std::max(a.y(), b.y());
+    }
+
+    bool Crossed(const Pnt& a, const Pnt& b, const Pnt& c, const Pnt& d) const {
+        int o1 = Orientation(a, b, c);
+        int o2 = Orientation(a, b, d);
+        int o3 = Orientation(c, d, a);
+        int o4 = Orientation(c, d, b);
+        if (o1 * o2 < 0 && o3 * o4 < 0)
+            return true;
+        return (o1 == 0 && OnSegment(c, a, b)) || (o2 == 0 && OnSegment(d, a, b))
+            || (o3 == 0 && OnSegment(a, c, d)) || (o4 == 0 && OnSegment(b, c, d));
+    }
+
+    // edges `e` and `e + 1` share a vertex and conflict only if they fold onto each other
+    bool Folded(const Pnt& a, const Pnt& s, const Pnt& d) const {
+        if (Orientation(a, s, d) != 0)
+            return false;
+        T dot = (static_cast<T>(a.x()) - s.x()) * (static_cast<T>(d.x()) - s.x())
+              + (static_cast<T>(a.y()) - s.y()) * (static_cast<T>(d.y()) - s.y());
+        return dot > 0;
+    }
+
+    // edges of the current ring which touch other edges, found by a sweep along x
+    std::vector<size_t> Conflicts() {
+        size_t m = ids_.size();
+        order_.resize(m);
+        for (size_t e = 0; e < m; ++e)
+            order_[e] = e;
+
+        auto from = [this] (size_t e) -> const Pnt& {
+            return points_[ids_[e]];
+        };
+        auto to = [this, m] (size_t e) -> const Pnt& {
+            return points_[ids_[e + 1 < m ? e + 1 : 0]];
+        };
+        std::sort(order_.begin(), order_.end(), [&] (size_t e, size_t f) {
+            return std::min(from(e).x(), to(e).x()) < std::min(from(f).x(), to(f).x());
+        });
+
+        std::vector<char> bad(m, 0);
+        active_.clear();
+        for (size_t e: order_) {
+            const Pnt& a = from(e);
+            const Pnt& b = to(e);
+            Tp min_x = std::min(a.x(), b.x());
+            size_t cnt = 0;
+            for (size_t f: active_) {
+                const Pnt& c = from(f);
+                const Pnt& d = to(f);
+                if (std::max(c.x(), d.x()) < min_x)
+                    continue;
+                active_[cnt++] = f;
+
+                bool hit;
+                if ((e + 1) % m == f)
+                    hit = Folded(a, b, d);
+                else if ((f + 1) % m == e)
+                    hit = Folded(c, d, b);
+                else
+                    hit = Crossed(a, b, c, d);
+                if (hit)
+                    bad[e] = bad[f] = 1;
+            }
+            active_.resize(cnt);
+            active_.push_back(e);
+        }
+
+        std::vector<size_t> res;
+        for (size_t e = 0; e < m; ++e)
+            if (bad[e])
+                res.push_back(e);
+        return res;
+    }
+
+private:
+    size_t n_;
+    double tolerance_;
+    std::vector<Pnt> points_;
+    std::vector<char> kept_;
+    std::vector<size_t> prev_;
+    std::vector<size_t> next_;
+    std::vector<size_t> stamp_;
+    std::vector<size_t> ids_;
+    std::vector<size_t> order_;
+    std::vector<size_t> active_;
+    std::vector<std::pair<size_t, size_t>> stack_;
+};
+
+template<typename Tp>
+Polygon<Tp> SimplifyDouglasPeucker(const Polygon<Tp>& polygon, double tolerance) {
+    return Simplifier<Tp>().DouglasPeucker(polygon, tolerance);
+}
+
+template<typename Tp>
+Polygon<Tp> SimplifyVisvalingam(const Polygon<Tp>& polygon, double tolerance,
+                                double max_area = std::numeric_limits<double>::infinity()) {
+    return Simplifier<Tp>().Visvalingam(polygon, tolerance, max_area);
+}
+
+// simplifies every polygon, blocks of polygons are taken by `threads` dynamically
+// `max_area` is used by VISVALINGAM only, see `Simplifier::Visvalingam`
+template<typename Tp>
+std::vector<Polygon<Tp>> Simplify(const std::vector<Polygon<Tp>>& polygons, double tolerance,
+                                  SimplificationType type = DOUGLAS_PEUCKER, size_t threads = 1,
+                                  double max_area = std::numeric_limits<double>::infinity()) {
+    std::vector<Polygon<Tp>> res(polygons.size());
+    ParallelBlocks(polygons.size(), threads, 64, [&] (size_t, size_t begin, size_t end) {
+        Simplifier<Tp> simplifier;
+        for (size_t i = begin; i < end; ++i) {
+            if (type == DOUGLAS_PEUCKER)
+                res[i] = simplifier.DouglasPeucker(polygons[i], tolerance);
+            else
+                res[i] = simplifier.Visvalingam(polygons[i], tolerance, max_area);
+        }
+    });
+    return res;
+}
+
+} // namespace geometry
+
+#endif // SIMPLIFICATION_H
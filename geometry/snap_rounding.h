@@ -0,0 +1,506 @@
+#ifndef SNAP_ROUNDING_H
+#define SNAP_ROUNDING_H
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <cstdint>
+#include <cassert>
+#include "point.h"
+#include "segment.h"
+#include "predicates.h"
+#include "parallel.h"
+
+// intersections and parameters along segments are exact in 128-bit products, there is
+// no `long long` fallback; `clipping.h` depends on this header too
+#ifndef __SIZEOF_INT128__
+#error "snap_rounding.h needs a compiler with a 128-bit integer type (__int128)"
+#endif
+
+namespace geometry {
+
+typedef Point<long long, 2> IntPoint;
+
+namespace detail {
+
+inline UInt128 IntegerPower(long long m, int power) {
+    UInt128 res = 1;
+    for (int i = 0; i < power; ++i)
+        res *= static_cast<unsigned long long>(m);
+    return res;
+}
+
+// the largest m with coefficient * m^power < 2^(bits - 1)
+inline long long MaxCoordinate(int bits, unsigned coefficient, int power) {
+    assert(bits <= 128);
+    UInt128 limit = ((static_cast<UInt128>(1) << (bits - 1)) - 1) / coefficient;
+    long long m = static_cast<long long>(std::pow(static_cast<long double>(limit), 1.0L / power));
+    while (m > 0 && IntegerPower(m, power) > limit)
+        --m;
+    while (IntegerPower(m + 1, power) <= limit)
+        ++m;
+    return m;
+}
+
+inline Int128 FloorDiv(Int128 a, Int128 b) {
+    assert(b > 0);
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+} // namespace detail
+
+// the largest |coordinate| of integer points, for which orientation and cross products of
+// differences fit into a signed integer of `bits` bits: 2 * (2m)^2 < 2^(bits - 1)
+// 2^30 - 1 for 64 bits
+inline long long MaxOrientationCoordinate(int bits = 64) {
+    return detail::MaxCoordinate(bits, 8, 2);
+}
+
+// the same for the incircle determinant: 3 * (2 * (2m)^2)^2 < 2^(bits - 1)
+// 970235263 for 128 bits, 14804 for 64 bits; the default is the width of `InCircleInteger`,
+// which `InCircle` of `IntPoint` uses
+inline long long MaxInCircleCoordinate(int bits = 8 * sizeof(InCircleInteger)) {
+    return detail::MaxCoordinate(bits, 192, 4);
+}
+
+// fixed-point grid, integer point (i, j) stands for origin + resolution * (i, j)
+struct SnapGrid {
+    double origin_x;
+    double origin_y;
+    double resolution;
+
+    template<typename Tp>
+    IntPoint Snap(const Point<Tp, 2>& p) const {
+        return IntPoint(std::llround((p.x() - origin_x) / resolution),
+                        std::llround((p.y() - origin_y) / resolution));
+    }
+
+    Point<double, 2> Unsnap(const IntPoint& p) const {
+        return Point<double, 2>(origin_x + p.x() * resolution, origin_y + p.y() * resolution);
+    }
+
+    // the finest grid centered at the bounding box of `points`, where snapped
+    // coordinates don't exceed `max_coordinate`
+    template<typename Tp>
+    static SnapGrid Fit(const std::vector<Point<Tp, 2>>& points,
+                        long long max_coordinate = MaxInCircleCoordinate())
+    {
+        assert(max_coordinate > 0);
+        if (points.empty())
+            return SnapGrid{0, 0, 1};
+
+        double min_x = points[0].x(), max_x = min_x;
+        double min_y = points[0].y(), max_y = min_y;
+        for (const auto& p: points) {
+            min_x = std::min<double>(min_x, p.x());
+            max_x = std::max<double>(max_x, p.x());
+            min_y = std::min<double>(min_y, p.y());
+            max_y = std::max<double>(max_y, p.y());
+        }
+
+        // a unit less leaves room for rounding to the nearest
+        double half = std::max(max_x - min_x, max_y - min_y) / 2;
+        double resolution = half / std::max<double>(max_coordinate - 1, 1);
+        if (!(resolution > 0))
+            resolution = 1;
+        return SnapGrid{(min_x + max_x) / 2, (min_y + max_y) / 2, resolution};
+    }
+
+    // the finest grid with a power of two resolution, where snapped coordinates don't exceed
+    // `max_coordinate`; the origin is a multiple of the resolution, so points already on
+    // the grid (integers, if the resolution is at most 1) are snapped exactly
+    template<typename Tp>
+    static SnapGrid Dyadic(const std::vector<Point<Tp, 2>>& points,
+                           long long max_coordinate = MaxOrientationCoordinate())
+    {
+        assert(max_coordinate > 1);
+        if (points.empty())
+            return SnapGrid{0, 0, 1};
+
+        double min_x = points[0].x(), max_x = min_x;
+        double min_y = points[0].y(), max_y = min_y;
+        for (const auto& p: points) {
+            min_x = std::min<double>(min_x, p.x());
+            max_x = std::max<double>(max_x, p.x());
+            min_y = std::min<double>(min_y, p.y());
+            max_y = std::max<double>(max_y, p.y());
+        }
+
+        // the rounded origin moves the center by half a unit, a unit less leaves room for it
+        double half = std::max(max_x - min_x, max_y - min_y) / 2;
+        int exponent;
+        std::frexp(half / (max_coordinate - 1), &exponent);
+        double resolution = std::ldexp(1.0, exponent);
+        return SnapGrid{std::round((min_x + max_x) / 2 / resolution) * resolution,
+                        std::round((min_y + max_y) / 2 / resolution) * resolution, resolution};
+    }
+};
+
+// integer input stage: points are snapped to a `SnapGrid`, duplicates are merged, and
+// segments between them are snap rounded (Hobby): pixels (unit squares [x - 1/2, x + 1/2) x
+// [y - 1/2, y + 1/2) around integer points) with a vertex or an intersection of segments
+// are hot, and every segment becomes the polyline through the centers of the hot pixels
+// it passes in the order along it; the polylines don't cross each other, they only meet
+// at vertices, and each stays within a pixel of its segment
+// snapped coordinates must not exceed `MaxOrientationCoordinate()`, then intersections,
+// their pixels and passes through pixels are found exactly in integers; choose the grid
+// by `MaxInCircleCoordinate` if the output goes to `InCircle`
+//
+// `FindIntersection` tells in O(n log n) whether segments cross at all, only then all
+// crossing pairs are enumerated by buckets of a coarse grid; the same buckets give
+// the hot pixels near every segment
+template<typename Tp = double>
+class SnapRounding {
+public:
+    typedef Point<Tp, 2> Pnt;
+
+public:
+    explicit SnapRounding(const SnapGrid& grid)
+        : grid_(grid)
+    {}
+
+    // `segments` are pairs of indices in `points`
+    void Build(const std::vector<Pnt>& points, const std::vector<std::pair<size_t, size_t>>& segments,
+               size_t threads = 1)
+    {
+        SnapPoints(points, threads);
+
+        segments_.clear();
+        for (const auto& s: segments) {
+            assert(s.first < points.size() && s.second < points.size());
+            segments_.push_back(std::make_pair(vertex_of_[s.first], vertex_of_[s.second]));
+        }
+
+        std::vector<IntPoint> hot;
+        FindHotPixels(hot, threads);
+        for (const IntPoint& p: hot)
+            vertices_.push_back(p);
+
+        Route(threads);
+    }
+
+    // distinct snapped points sorted lexicographically, then centers of hot pixels
+    // of intersections
+    const std::vector<IntPoint>& Vertices() const {
+        return vertices_;
+    }
+
+    // vertex of input point `i`
+    size_t VertexOf(size_t i) const {
+        return vertex_of_[i];
+    }
+
+    // vertices of segment `k` from its first point to the second are
+    // chains[offsets[k]], ..., chains[offsets[k + 1] - 1]
+    const std::vector<size_t>& Offsets() const {
+        return offsets_;
+    }
+
+    const std::vector<size_t>& Chains() const {
+        return chains_;
+    }
+
+private:
+    // parameter along a segment, num / den with den > 0
+    struct Bound {
+        long long num;
+        long long den;
+        bool closed;
+
+        bool Less(const Bound& oth) const {
+            return static_cast<Int128>(num) * oth.den < static_cast<Int128>(oth.num) * den;
+        }
+
+        bool Same(const Bound& oth) const {
+            return static_cast<Int128>(num) * oth.den == static_cast<Int128>(oth.num) * den;
+        }
+
+        // entries of disjoint pixels may coincide only if one of them is open
+        bool operator<(const Bound& oth) const {
+            return Less(oth) || (Same(oth) && closed && !oth.closed);
+        }
+    };
+
+    struct Cell {
+        long long x;
+        long long y;
+        size_t id;
+
+        bool operator<(const Cell& oth) const {
+            return x < oth.x || (x == oth.x && (y < oth.y || (y == oth.y && id < oth.id)));
+        }
+
+        bool SameCell(const Cell& oth) const {
+            return x == oth.x && y == oth.y;
+        }
+    };
+
+    void SnapPoints(const std::vector<Pnt>& points, size_t threads) {
+        std::vector<std::pair<IntPoint, size_t>> snapped(points.size());
+        long long max_coordinate = MaxOrientationCoordinate();
+        ParallelFor(points.size(), threads, [&] (size_t i) {
+            snapped[i] = std::make_pair(grid_.Snap(points[i]), i);
+            assert(std::abs(snapped[i].first.x()) <= max_coordinate &&
+                   std::abs(snapped[i].first.y()) <= max_coordinate);
+        });
+        (void) max_coordinate;
+        ParallelSort(snapped.begin(), snapped.end(), [] (const std::pair<IntPoint, size_t>& a,
+                                                         const std::pair<IntPoint, size_t>& b) {
+            return a < b;
+        }, threads);
+
+        vertices_.clear();
+        vertex_of_.resize(points.size());
+        for (size_t i = 0; i < snapped.size(); ++i) {
+            if (i == 0 || !(snapped[i - 1].first == snapped[i].first))
+                vertices_.push_back(snapped[i].first);
+            vertex_of_[snapped[i].second] = vertices_.size() - 1;
+        }
+    }
+
+    // cells of the coarse grid, which may contain centers of pixels passed by segment `s`:
+    // a column takes the part of the segment a unit wider than it, rows are a unit wider too
+    void SegmentCells(size_t s, std::vector<Cell>& res) const {
+        const IntPoint& a = vertices_[segments_[s].first];
+        const IntPoint& b = vertices_[segments_[s].second];
+        long long min_x = std::min(a.x(), b.x()), max_x = std::max(a.x(), b.x());
+
+        for (long long col = CellOf(min_x - 1); col <= CellOf(max_x + 1); ++col) {
+            double lo = std::max<double>(min_x, col * cell_ - 1);
+            double hi = std::min<double>(max_x, (col + 1) * cell_ + 1);
+            double y1 = a.y(), y2 = b.y();
+            if (a.x() != b.x()) {
+                double slope = static_cast<double>(b.y() - a.y()) / (b.x() - a.x());
+                y1 = a.y() + (lo - a.x()) * slope;
+                y2 = a.y() + (hi - a.x()) * slope;
+            }
+            long long row_from = CellOf(static_cast<long long>(std::floor(std::min(y1, y2))) - 1);
+            long long row_to = CellOf(static_cast<long long>(std::ceil(std::max(y1, y2))) + 1);
+            for (long long row = row_from; row <= row_to; ++row)
+                res.push_back(Cell{col, row, s});
+        }
+    }
+
+    long long CellOf(long long x) const {
+        return static_cast<long long>(detail::FloorDiv(x, cell_));
+    }
+
+    // cell size giving about one item per cell
+    void ChooseCell(size_t items) {
+        long long extent = 1;
+        if (!vertices_.empty()) {
+            long long min_x = vertices_[0].x(), max_x = min_x;
+            long long min_y = vertices_[0].y(), max_y = min_y;
+            for (const IntPoint& p: vertices_) {
+                min_x = std::min(min_x, p.x());
+                max_x = std::max(max_x, p.x());
+                min_y = std::min(min_y, p.y());
+                max_y = std::max(max_y, p.y());
+            }
+            extent = std::max(std::max(max_x - min_x, max_y - min_y), 1LL);
+        }
+        cell_ = std::max(1LL, static_cast<long long>(extent / std::sqrt(std::max<double>(items, 1))));
+    }
+
+    bool Adjacent(size_t i, size_t j) const {
+        return segments_[i].first == segments_[j].first || segments_[i].first == segments_[j].second ||
+               segments_[i].second == segments_[j].first || segments_[i].second == segments_[j].second;
+    }
+
+    // appends the pixel of the intersection of two segments, if they cross at one point
+    void Intersection(size_t i, size_t j, std::vector<IntPoint>& hot) const {
+        const IntPoint& p = vertices_[segments_[i].first];
+        const IntPoint& q = vertices_[segments_[j].first];
+        IntPoint r = vertices_[segments_[i].second] - p;
+        IntPoint s = vertices_[segments_[j].second] - q;
+
+        // p + r * num / den
+        Int128 den = Vector<long long>(r).Cross(Vector<long long>(s));
+        if (den == 0)
+            return;
+
+        Int128 num = Vector<long long>(p, q).Cross(Vector<long long>(s));
+        if (den < 0) {
+            den = -den;
+            num = -num;
+        }
+        if (num < 0 || num > den)
+            return;
+
+        // the nearest integer, halves go up like the pixels
+        Int128 x = static_cast<Int128>(p.x()) * den + static_cast<Int128>(r.x()) * num;
+        Int128 y = static_cast<Int128>(p.y()) * den + static_cast<Int128>(r.y()) * num;
+        hot.push_back(IntPoint(static_cast<long long>(detail::FloorDiv(2 * x + den, 2 * den)),
+                               static_cast<long long>(detail::FloorDiv(2 * y + den, 2 * den))));
+    }
+
+    // centers of the pixels of intersections, which aren't vertices already
+    void FindHotPixels(std::vector<IntPoint>& hot, size_t threads) {
+        std::vector<Segment<long long>> segments;
+        std::vector<size_t> ids;
+        for (size_t k = 0; k < segments_.size(); ++k) {
+            if (segments_[k].first != segments_[k].second) {
+                segments.push_back(Segment<long long>(vertices_[segments_[k].first],
+                                                      vertices_[segments_[k].second]));
+                ids.push_back(k);
+            }
+        }
+
+        auto crossing = FindIntersection(segments, [this, &ids] (int i, int j) {
+            return Adjacent(ids[i], ids[j]);
+        });
+        if (crossing.first < 0)
+            return;
+
+        ChooseCell(ids.size());
+        std::vector<std::vector<Cell>> chunk_cells(ThreadsCount(threads, ids.size()));
+        ParallelChunks(ids.size(), chunk_cells.size(), [&] (size_t chunk, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                SegmentCells(ids[i], chunk_cells[chunk]);
+        });
+        std::vector<Cell> cells;
+        for (const auto& chunk: chunk_cells)
+            cells.insert(cells.end(), chunk.begin(), chunk.end());
+        ParallelSort(cells.begin(), cells.end(), [] (const Cell& a, const Cell& b) {
+            return a < b;
+        }, threads);
+
+        std::vector<size_t> starts;
+        for (size_t i = 0; i < cells.size(); ++i)
+            if (i == 0 || !cells[i - 1].SameCell(cells[i]))
+                starts.push_back(i);
+        starts.push_back(cells.size());
+
+        std::vector<std::vector<IntPoint>> chunk_hot(ThreadsCount(threads, starts.size() - 1));
+        ParallelBlocks(starts.size() - 1, chunk_hot.size(), 64, [&] (size_t thread, size_t begin, size_t end) {
+            for (size_t c = begin; c < end; ++c) {
+                for (size_t i = starts[c]; i < starts[c + 1]; ++i) {
+                    for (size_t j = i + 1; j < starts[c + 1]; ++j) {
+                        size_t a = cells[i].id, b = cells[j].id;
+                        if (Adjacent(a, b))
+                            continue;
+                        Segment<long long> sa(vertices_[segments_[a].first], vertices_[segments_[a].second]);
+                        Segment<long long> sb(vertices_[segments_[b].first], vertices_[segments_[b].second]);
+                        if (sa.Intersected(sb))
+                            Intersection(a, b, chunk_hot[thread]);
+                    }
+                }
+            }
+        });
+
+        for (const auto& chunk: chunk_hot)
+            hot.insert(hot.end(), chunk.begin(), chunk.end());
+        std::sort(hot.begin(), hot.end());
+        hot.erase(std::unique(hot.begin(), hot.end()), hot.end());
+        hot.erase(std::remove_if(hot.begin(), hot.end(), [this] (const IntPoint& p) {
+            return std::binary_search(vertices_.begin(), vertices_.end(), p);
+        }), hot.end());
+    }
+
+    // narrows [lo, hi] to the parameters where `from + t * delta` lies in [min, max)
+    static bool Clip(long long from, long long delta, long long min, long long max, Bound& lo, Bound& hi) {
+        if (delta == 0)
+            return min <= from && from < max;
+
+        Bound enter{min - from, delta, true};
+        Bound leave{max - from, delta, false};
+        if (delta < 0) {
+            enter = Bound{from - max, -delta, false};
+            leave = Bound{from - min, -delta, true};
+        }
+
+        if (lo.Less(enter))
+            lo = enter;
+        else if (lo.Same(enter))
+            lo.closed = lo.closed && enter.closed;
+
+        if (leave.Less(hi))
+            hi = leave;
+        else if (hi.Same(leave))
+            hi.closed = hi.closed && leave.closed;
+        return true;
+    }
+
+    // whether segment `s` passes the pixel of `c`, `entry` is the parameter where it enters
+    bool Passes(size_t s, const IntPoint& c, Bound& entry) const {
+        // doubled coordinates make the pixel borders integer
+        const IntPoint& a = vertices_[segments_[s].first];
+        const IntPoint& b = vertices_[segments_[s].second];
+        Bound lo{0, 1, true};
+        Bound hi{1, 1, true};
+        if (!Clip(2 * a.x(), 2 * (b.x() - a.x()), 2 * c.x() - 1, 2 * c.x() + 1, lo, hi) ||
+            !Clip(2 * a.y(), 2 * (b.y() - a.y()), 2 * c.y() - 1, 2 * c.y() + 1, lo, hi))
+            return false;
+
+        entry = lo;
+        return lo.Less(hi) || (lo.Same(hi) && lo.closed && hi.closed);
+    }
+
+    // polylines through the hot pixels, which are all vertices now
+    void Route(size_t threads) {
+        ChooseCell(segments_.size() + vertices_.size());
+
+        std::vector<Cell> pixels(vertices_.size());
+        ParallelFor(vertices_.size(), threads, [&] (size_t v) {
+            pixels[v] = Cell{CellOf(vertices_[v].x()), CellOf(vertices_[v].y()), v};
+        });
+        ParallelSort(pixels.begin(), pixels.end(), [] (const Cell& a, const Cell& b) {
+            return a < b;
+        }, threads);
+
+        std::vector<std::vector<size_t>> chains(segments_.size());
+        std::vector<std::vector<Cell>> scratch(ThreadsCount(threads, segments_.size()));
+        ParallelBlocks(segments_.size(), scratch.size(), 64, [&] (size_t thread, size_t begin, size_t end) {
+            std::vector<Cell>& cells = scratch[thread];
+            std::vector<std::pair<Bound, size_t>> passed;
+            for (size_t s = begin; s < end; ++s) {
+                if (segments_[s].first == segments_[s].second) {
+                    chains[s].push_back(segments_[s].first);
+                    continue;
+                }
+
+                cells.clear();
+                passed.clear();
+                SegmentCells(s, cells);
+                for (const Cell& cell: cells) {
+                    auto it = std::lower_bound(pixels.begin(), pixels.end(), Cell{cell.x, cell.y, 0});
+                    for (; it != pixels.end() && it->SameCell(cell); ++it) {
+                        Bound entry;
+                        if (Passes(s, vertices_[it->id], entry))
+                            passed.push_back(std::make_pair(entry, it->id));
+                    }
+                }
+
+                std::sort(passed.begin(), passed.end(), [] (const std::pair<Bound, size_t>& a,
+                                                            const std::pair<Bound, size_t>& b) {
+                    return a.first < b.first || (!(b.first < a.first) && a.second < b.second);
+                });
+                for (const auto& p: passed)
+                    if (chains[s].empty() || chains[s].back() != p.second)
+                        chains[s].push_back(p.second);
+            }
+        });
+
+        offsets_.assign(1, 0);
+        chains_.clear();
+        for (const auto& chain: chains) {
+            chains_.insert(chains_.end(), chain.begin(), chain.end());
+            offsets_.push_back(chains_.size());
+        }
+    }
+
+private:
+    SnapGrid grid_;
+    long long cell_;
+
+    std::vector<IntPoint> vertices_;
+    std::vector<size_t> vertex_of_;
+    std::vector<std::pair<size_t, size_t>> segments_;
+
+    std::vector<size_t> offsets_;
+    std::vector<size_t> chains_;
+};
+
+} // namespace geometry
+
+#endif // SNAP_ROUNDING_H
@@ -0,0 +1,150 @@
+#ifndef SPATIAL_SORT_H
+#define SPATIAL_SORT_H
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+#include "point.h"
+
+namespace geometry {
+
+// returns position of cell (`x`, `y`) on the Hilbert curve of order `order`
+inline uint64_t HilbertIndex(uint32_t x, uint32_t y, int order) {
+    uint64_t d = 0;
+    for (uint32_t s = 1u << (order - 1); s > 0; s >>= 1) {
+        uint32_t rx = (x & s) > 0;
+        uint32_t ry = (y & s) > 0;
+        d += (uint64_t) s * s * ((3 * rx) ^ ry);
+
+        // rotate quadrant
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+
+    return d;
+}
+
+// returns indices of `points` ordered along the Hilbert curve
+// consecutive points are close to each other, so walking point location stays short
+template<typename Tp>
+std::vector<size_t> HilbertOrder(const std::vector<Point<Tp, 2>>& points) {
+    const int order = 16;
+    const double cells = (1u << order) - 1;
+
+    std::vector<size_t> res(points.size());
+    if (points.empty())
+        return res;
+
+    double min_x = points[0].x(), max_x = min_x;
+    double min_y = points[0].y(), max_y = min_y;
+    for (const auto& p: points) {
+        min_x = std::min(min_x, (double) p.x());
+        max_x = std::max(max_x, (double) p.x());
+        min_y = std::min(min_y, (double) p.y());
+        max_y = std::max(max_y, (double) p.y());
+    }
+    double scale = std::max(max_x - min_x, max_y - min_y);
+    scale = scale > 0 ? cells / scale : 0;
+
+    std::vector<std::pair<uint64_t, size_t>> keys(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        uint32_t x = static_cast<uint32_t>((points[i].x() - min_x) * scale);
+        uint32_t y = static_cast<uint32_t>((points[i].y() - min_y) * scale);
+        keys[i] = std::make_pair(HilbertIndex(x, y, order), i);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    for (size_t i = 0; i < keys.size(); ++i)
+        res[i] = keys[i].second;
+
+    return res;
+}
+
+// returns position of cell `x` on the `dim`-dimensional Hilbert curve with `bits` bits per axis
+// Skilling's transform, `x` is destroyed
+template<size_t dim>
+uint64_t HilbertIndex(uint32_t (&x)[dim], int bits) {
+    uint32_t m = 1u << (bits - 1);
+
+    // inverse undo
+    for (uint32_t q = m; q > 1; q >>= 1) {
+        uint32_t p = q - 1;
+        for (size_t i = 0; i < dim; ++i) {
+            if (x[i] & q) {
+                x[0] ^= p;
+            } else {
+                uint32_t t = (x[0] ^ x[i]) & p;
+                x[0] ^= t;
+                x[i] ^= t;
+            }
+        }
+    }
+
+    // gray encode
+    for (size_t i = 1; i < dim; ++i)
+        x[i] ^= x[i - 1];
+    uint32_t t = 0;
+    for (uint32_t q = m; q > 1; q >>= 1) {
+        if (x[dim - 1] & q)
+            t ^= q - 1;
+    }
+    for (size_t i = 0; i < dim; ++i)
+        x[i] ^= t;
+
+    // interleave the transposed index
+    uint64_t d = 0;
+    for (int b = bits - 1; b >= 0; --b) {
+        for (size_t i = 0; i < dim; ++i)
+            d = (d << 1) | ((x[i] >> b) & 1);
+    }
+
+    return d;
+}
+
+// returns indices of `points` ordered along the `dim`-dimensional Hilbert curve
+template<typename Tp, size_t dim>
+std::vector<size_t> HilbertOrder(const std::vector<Point<Tp, dim>>& points) {
+    const int bits = static_cast<int>(std::min<size_t>(64 / dim, 31));
+    const double cells = (1u << bits) - 1;
+
+    std::vector<size_t> res(points.size());
+    if (points.empty())
+        return res;
+
+    double lo[dim], hi[dim];
+    for (size_t d = 0; d < dim; ++d)
+        lo[d] = hi[d] = points[0].Get(d);
+    for (const auto& p: points) {
+        for (size_t d = 0; d < dim; ++d) {
+            lo[d] = std::min(lo[d], (double) p.Get(d));
+            hi[d] = std::max(hi[d], (double) p.Get(d));
+        }
+    }
+    double scale = 0;
+    for (size_t d = 0; d < dim; ++d)
+        scale = std::max(scale, hi[d] - lo[d]);
+    scale = scale > 0 ? cells / scale : 0;
+
+    std::vector<std::pair<uint64_t, size_t>> keys(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        uint32_t x[dim];
+        for (size_t d = 0; d < dim; ++d)
+            x[d] = static_cast<uint32_t>((points[i].Get(d) - lo[d]) * scale);
+        keys[i] = std::make_pair(HilbertIndex(x, bits), i);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    for (size_t i = 0; i < keys.size(); ++i)
+        res[i] = keys[i].second;
+
+    return res;
+}
+
+} // namespace geometry
+
+#endif // SPATIAL_SORT_H
@@ -0,0 +1,625 @@
+#ifndef TILED_DELAUNAY_H
+#define TILED_DELAUNAY_H
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include "point.h"
+#include "predicates.h"
+#include "circle.h"
+#include "triangle_mesh.h"
+#include "delaunay.h"
+#include "parallel.h"
+
+namespace geometry {
+
+// axis-aligned box, the boundary belongs to it
+struct TileBox {
+    double min_x, min_y, max_x, max_y;
+
+    bool Contains(double x, double y) const {
+        return min_x <= x && x <= max_x && min_y <= y && y <= max_y;
+    }
+};
+
+// everything a worker knows about its tile besides the points
+struct TileHeader {
+    TileBox grid;
+    double width;
+    double height;
+    uint64_t tiles_x;
+    uint64_t tiles_y;
+    uint64_t tile_x;
+    uint64_t tile_y;
+    TileBox halo;
+    uint64_t count;
+};
+
+namespace detail {
+
+template<typename T>
+void WriteRaw(std::ostream& out, const T* data, size_t count) {
+    out.write(reinterpret_cast<const char*>(data), count * sizeof(T));
+}
+
+template<typename T>
+bool ReadRaw(std::istream& in, T* data, size_t count) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(data), count * sizeof(T)));
+}
+
+inline bool ReadMagic(std::istream& in, const char* magic) {
+    char buf[4];
+    return ReadRaw(in, buf, 4) && std::memcmp(buf, magic, 4) == 0;
+}
+
+// tile of `pos` along one axis of the grid, points beyond the grid belong to the outer tiles
+// returns false if `pos` is so close to a border between tiles that circumcenters
+// of cocircular points, computed from different triples, could fall on different sides
+inline bool TileAxis(double pos, double min, double size, uint64_t count, uint64_t& tile) {
+    const double EPS = 1e-6;
+
+    double cell = (pos - min) / size;
+    if (!std::isfinite(cell))
+        return false;
+
+    cell = std::min(std::max(cell, 0.0), static_cast<double>(count));
+    tile = std::min<uint64_t>(count - 1, static_cast<uint64_t>(cell));
+    double frac = cell - tile;
+    return (tile == 0 || frac > EPS) && (tile + 1 == count || frac < 1 - EPS);
+}
+
+} // namespace detail
+
+// worker side of `TiledDelaunay`: reads a tile written by `WriteTile` from `in`,
+// triangulates its points with the halo and writes to `out` the triangles, which the tile
+// owns and certifies (see `TiledDelaunay`), as a `TriangleMesh` over the tile points;
+// points skipped as duplicates are listed too
+// a worker process may be as small as
+//
+//     int main() { return geometry::TriangulateTile<double>(std::cin, std::cout) ? 0 : 1; }
+//
+// returns false if `in` isn't a tile of points of type `Tp`
+template<typename Tp, typename Index = uint32_t>
+bool TriangulateTile(std::istream& in, std::ostream& out) {
+    typedef Point<Tp, 2> Pnt;
+
+    TileHeader header;
+    uint64_t size;
+    if (!detail::ReadMagic(in, "TILE") || !detail::ReadRaw(in, &size, 1) || size != sizeof(Tp))
+        return false;
+    if (!detail::ReadRaw(in, &header, 1))
+        return false;
+
+    std::vector<uint64_t> ids;
+    std::vector<Pnt> points;
+    if (!detail::ReadArray(in, ids, header.count) || !detail::ReadArray(in, points, header.count))
+        return false;
+
+    Delaunay<Tp, Index> delaunay(points);
+    const TriangleMesh<Index>& mesh = delaunay.GetMesh();
+    const TileBox& grid = header.grid;
+    const TileBox& halo = header.halo;
+    double scale = std::max(std::max(std::abs(grid.min_x), std::abs(grid.max_x)),
+                            std::max(std::abs(grid.min_y), std::abs(grid.max_y)));
+
+    TriangleMesh<Index> res(points.size());
+    for (size_t t = 0; t < mesh.TrianglesCount(); ++t) {
+        Index a = mesh.Vertex(t, 0), b = mesh.Vertex(t, 1), c = mesh.Vertex(t, 2);
+        Point<double> center = Circumcenter(points[a], points[b], points[c]);
+        double radius = Circumradius(points[a], points[b], points[c]);
+        double ux = center.x(), uy = center.y();
+
+        // the tile owns triangles with circumcenters inside it
+        uint64_t tile_x, tile_y;
+        if (!detail::TileAxis(ux, grid.min_x, header.width, header.tiles_x, tile_x) ||
+            !detail::TileAxis(uy, grid.min_y, header.height, header.tiles_y, tile_y))
+            continue;
+        if (tile_x != header.tile_x || tile_y != header.tile_y)
+            continue;
+
+        // and certifies them, if the part of the circumcircle inside the grid lies inside
+        // the halo, then all points of the circle were triangulated here
+        double r = radius * (1 + 1e-9) + scale * 1e-12;
+        if (std::max(ux - r, grid.min_x) >= halo.min_x && std::min(ux + r, grid.max_x) <= halo.max_x &&
+            std::max(uy - r, grid.min_y) >= halo.min_y && std::min(uy + r, grid.max_y) <= halo.max_y)
+            res.AddTriangle(a, b, c);
+    }
+
+    std::vector<uint64_t> duplicates;
+    if (mesh.TrianglesCount() > 0) {
+        for (size_t v = 0; v < points.size(); ++v)
+            if (mesh.VertexEdge(v) == TriangleMesh<Index>::NONE)
+                duplicates.push_back(ids[v]);
+    }
+
+    uint64_t counts[2] = {ids.size(), duplicates.size()};
+    out.write("TRES", 4);
+    detail::WriteRaw(out, counts, 2);
+    detail::WriteRaw(out, ids.data(), ids.size());
+    detail::WriteRaw(out, duplicates.data(), duplicates.size());
+    res.WriteBinary(out);
+    return static_cast<bool>(out);
+}
+
+// Delaunay triangulation of points, which don't fit one process
+//
+// the bounding box is cut into a grid of tiles, a tile is written with the points of its halo
+// (points not farther than `halo` from the tile along each axis) and triangulated by
+// `TriangulateTile`, possibly in another process or on another machine
+// a tile keeps only triangles, which it owns (the circumcenter lies in the tile)
+// and certifies (the circumcircle lies in the halo, so no point outside the tile input can be
+// inside it), these triangles are in the global triangulation and every triangle is owned
+// by one tile
+//
+// `Stitch` merges the certified triangles, the uncovered seams between them are triangulated
+// again by the points of their boundaries and the points not used by any tile, then
+// the empty circle property is checked on every edge between triangles of different origin;
+// triangles failing the check are uncertified and the seams are stitched again
+// a tile, whose result is lost, only widens the seams
+//
+// vertex ids of the mesh are indices of points, duplicates aren't part of any triangle
+// `points` must outlive the triangulation
+template<typename Tp, typename Index = uint32_t>
+class TiledDelaunay {
+public:
+    typedef Point<Tp, 2> Pnt;
+    typedef TriangleMesh<Index> Mesh;
+
+    static const Index NONE = Mesh::NONE;
+
+public:
+    TiledDelaunay(const std::vector<Pnt>& points, size_t tiles_x, size_t tiles_y, double halo)
+        : points_(points)
+        , duplicate_(points.size(), 0)
+        , halo_(halo)
+        , seam_points_(0)
+    {
+        assert(tiles_x > 0 && tiles_y > 0 && halo >= 0);
+
+        header_.tiles_x = tiles_x;
+        header_.tiles_y = tiles_y;
+        header_.grid = TileBox{0, 0, 0, 0};
+        if (!points_.empty()) {
+            double x = points_[0].x(), y = points_[0].y();
+            header_.grid = TileBox{x, y, x, y};
+        }
+        for (const Pnt& p: points_) {
+            header_.grid.min_x = std::min<double>(header_.grid.min_x, p.x());
+            header_.grid.min_y = std::min<double>(header_.grid.min_y, p.y());
+            header_.grid.max_x = std::max<double>(header_.grid.max_x, p.x());
+            header_.grid.max_y = std::max<double>(header_.grid.max_y, p.y());
+        }
+        header_.width = (header_.grid.max_x - header_.grid.min_x) / tiles_x;
+        header_.height = (header_.grid.max_y - header_.grid.min_y) / tiles_y;
+        if (!(header_.width > 0))
+            header_.width = 1;
+        if (!(header_.height > 0))
+            header_.height = 1;
+
+        // points are bucketed by tiles, ids stay ascending inside a bucket
+        std::vector<size_t> tiles(points_.size());
+        starts_.assign(TilesCount() + 1, 0);
+        for (size_t i = 0; i < points_.size(); ++i) {
+            tiles[i] = TileOf(points_[i].x(), points_[i].y());
+            ++starts_[tiles[i] + 1];
+        }
+        for (size_t t = 0; t < TilesCount(); ++t)
+            starts_[t + 1] += starts_[t];
+
+        bucket_.resize(points_.size());
+        std::vector<size_t> pos(starts_.begin(), starts_.end() - 1);
+        for (size_t i = 0; i < points_.size(); ++i)
+            bucket_[pos[tiles[i]]++] = i;
+    }
+
+    size_t TilesCount() const {
+        return header_.tiles_x * header_.tiles_y;
+    }
+
+    // writes the input of a worker
+    void WriteTile(size_t tile, std::ostream& out) const {
+        assert(tile < TilesCount());
+
+        TileHeader header = header_;
+        header.tile_x = tile % header_.tiles_x;
+        header.tile_y = tile / header_.tiles_x;
+        const TileBox& grid = header_.grid;
+        header.halo.min_x = std::max(grid.min_x, grid.min_x + header.tile_x * header.width - halo_);
+        header.halo.min_y = std::max(grid.min_y, grid.min_y + header.tile_y * header.height - halo_);
+        header.halo.max_x = std::min(grid.max_x, grid.min_x + (header.tile_x + 1) * header.width + halo_);
+        header.halo.max_y = std::min(grid.max_y, grid.min_y + (header.tile_y + 1) * header.height + halo_);
+
+        // buckets of the tiles around the halo, one more on every side for rounding
+        size_t from_x = TileIndex(header.halo.min_x, grid.min_x, header.width, header.tiles_x);
+        size_t from_y = TileIndex(header.halo.min_y, grid.min_y, header.height, header.tiles_y);
+        size_t to_x = TileIndex(header.halo.max_x, grid.min_x, header.width, header.tiles_x);
+        size_t to_y = TileIndex(header.halo.max_y, grid.min_y, header.height, header.tiles_y);
+        from_x -= from_x > 0;
+        from_y -= from_y > 0;
+        to_x = std::min<size_t>(to_x + 1, header.tiles_x - 1);
+        to_y = std::min<size_t>(to_y + 1, header.tiles_y - 1);
+
+        std::vector<uint64_t> ids;
+        for (size_t y = from_y; y <= to_y; ++y) {
+            for (size_t x = from_x; x <= to_x; ++x) {
+                size_t t = y * header.tiles_x + x;
+                for (size_t i = starts_[t]; i < starts_[t + 1]; ++i) {
+                    const Pnt& p = points_[bucket_[i]];
+                    if (header.halo.Contains(p.x(), p.y()))
+                        ids.push_back(bucket_[i]);
+                }
+            }
+        }
+        // the same order everywhere makes every tile skip the same duplicates
+        std::sort(ids.begin(), ids.end());
+
+        std::vector<Pnt> points(ids.size());
+        for (size_t i = 0; i < ids.size(); ++i)
+            points[i] = points_[ids[i]];
+
+        uint64_t size = sizeof(Tp);
+        header.count = ids.size();
+        out.write("TILE", 4);
+        detail::WriteRaw(out, &size, 1);
+        detail::WriteRaw(out, &header, 1);
+        detail::WriteRaw(out, ids.data(), ids.size());
+        detail::WriteRaw(out, points.data(), points.size());
+    }
+
+    // reads the output of the worker of `tile`, returns false if it's broken,
+    // then the tile adds nothing
+    bool ReadResult(size_t tile, std::istream& in) {
+        assert(tile < TilesCount());
+
+        uint64_t counts[2];
+        if (!detail::ReadMagic(in, "TRES") || !detail::ReadRaw(in, counts, 2))
+            return false;
+
+        // counts aren't trusted, the arrays grow as their data is read
+        std::vector<uint64_t> ids;
+        std::vector<uint64_t> duplicates;
+        Mesh mesh;
+        if (!detail::ReadArray(in, ids, counts[0]) || !detail::ReadArray(in, duplicates, counts[1]) ||
+            !mesh.ReadBinary(in) || mesh.VerticesCount() != ids.size())
+            return false;
+        for (uint64_t id: ids)
+            if (id >= points_.size())
+                return false;
+        for (uint64_t id: duplicates)
+            if (id >= points_.size())
+                return false;
+
+        for (uint64_t id: duplicates)
+            duplicate_[id] = 1;
+        for (Index v: mesh.Triangles())
+            triangles_.push_back(static_cast<Index>(ids[v]));
+        tiles_.insert(tiles_.end(), mesh.TrianglesCount(), tile);
+        return true;
+    }
+
+    // builds the mesh from the certified triangles and the seams
+    void Stitch(size_t threads = 1) {
+        while (!StitchOnce(threads)) {}
+
+        triangles_.clear();
+        tiles_.clear();
+    }
+
+    const Mesh& GetMesh() const {
+        return mesh_;
+    }
+
+    // count of points triangulated by the last `Stitch`, the rest came from the tiles
+    size_t SeamPointsCount() const {
+        return seam_points_;
+    }
+
+private:
+    // origin of triangles triangulated by `Stitch`
+    static const size_t SEAM = static_cast<size_t>(-1);
+
+    static size_t TileIndex(double pos, double min, double size, uint64_t count) {
+        double cell = std::min(std::max((pos - min) / size, 0.0), static_cast<double>(count));
+        return std::min<size_t>(count - 1, static_cast<size_t>(cell));
+    }
+
+    size_t TileOf(double x, double y) const {
+        return TileIndex(y, header_.grid.min_y, header_.height, header_.tiles_y) * header_.tiles_x +
+               TileIndex(x, header_.grid.min_x, header_.width, header_.tiles_x);
+    }
+
+    // mesh_ of certified triangles, their origins are in `origins_`
+    void BuildCertified() {
+        mesh_.Clear();
+        mesh_.ResizeVertices(points_.size());
+        mesh_.Reserve(2 * points_.size());
+        for (size_t i = 0; i < triangles_.size(); i += 3)
+            mesh_.AddTriangle(triangles_[i], triangles_[i + 1], triangles_[i + 2]);
+        mesh_.BuildAdjacency();
+        origins_ = tiles_;
+    }
+
+    // marks triangles at broken adjacency: a twin pointing elsewhere (an edge of three
+    // triangles) or two boundary half-edges going the same way
+    bool CheckTopology(std::vector<char>& bad) const {
+        std::vector<std::pair<std::pair<Index, Index>, Index>> boundary;
+        bool ok = true;
+        for (size_t h = 0; h < mesh_.Triangles().size(); ++h) {
+            Index twin = mesh_.Twin(h);
+            if (twin == NONE) {
+                boundary.push_back(std::make_pair(std::make_pair(mesh_.Origin(h), mesh_.Target(h)), h));
+            } else if (mesh_.Twin(twin) != h) {
+                bad[h / 3] = bad[twin / 3] = 1;
+                ok = false;
+            }
+        }
+
+        std::sort(boundary.begin(), boundary.end());
+        for (size_t i = 1; i < boundary.size(); ++i) {
+            if (boundary[i - 1].first == boundary[i].first) {
+                bad[boundary[i - 1].second / 3] = bad[boundary[i].second / 3] = 1;
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+    // marks triangles at edges between different origins, which aren't locally Delaunay
+    bool CheckSeams(std::vector<char>& bad, size_t threads) const {
+        std::vector<char> res(mesh_.TrianglesCount(), 0);
+        ParallelFor(mesh_.TrianglesCount(), threads, [&] (size_t t) {
+            for (Index h = 3 * t; h < 3 * t + 3; ++h) {
+                Index twin = mesh_.Twin(h);
+                if (twin == NONE || origins_[t] == origins_[twin / 3])
+                    continue;
+                const Pnt& far = points_[mesh_.Origin(Mesh::Prev(twin))];
+                if (InCircle(points_[mesh_.Vertex(t, 0)], points_[mesh_.Vertex(t, 1)],
+                             points_[mesh_.Vertex(t, 2)], far) > 0)
+                    res[t] = 1;
+            }
+        });
+
+        bool ok = true;
+        for (size_t t = 0; t < res.size(); ++t) {
+            if (res[t]) {
+                bad[t] = 1;
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+    // the boundary must be one convex counterclockwise loop and the count of triangles
+    // must be the one of a triangulated disk: 2 * vertices - 2 - boundary vertices
+    bool CheckBoundary() const {
+        std::vector<Index> out(points_.size(), NONE);
+        size_t boundary = 0;
+        for (size_t h = 0; h < mesh_.Triangles().size(); ++h) {
+            if (mesh_.Twin(h) != NONE)
+                continue;
+            if (out[mesh_.Origin(h)] != NONE)
+                return false;
+            out[mesh_.Origin(h)] = h;
+            ++boundary;
+        }
+
+        size_t vertices = 0;
+        for (size_t v = 0; v < points_.size(); ++v)
+            vertices += mesh_.VertexEdge(v) != NONE;
+        if (vertices == 0)
+            return true;
+        if (mesh_.TrianglesCount() + 2 + boundary != 2 * vertices)
+            return false;
+
+        for (size_t h = 0; h < mesh_.Triangles().size(); ++h) {
+            if (mesh_.Twin(h) != NONE)
+                continue;
+            Index next = out[mesh_.Target(h)];
+            if (next == NONE || Orientation(points_[mesh_.Origin(h)], points_[mesh_.Target(h)],
+                                            points_[mesh_.Target(next)]) < 0)
+                return false;
+        }
+        return true;
+    }
+
+    // drops certified triangles marked in `bad` and the ones sharing a vertex with them
+    void Uncertify(const std::vector<char>& bad) {
+        std::vector<char> vertex(points_.size(), 0);
+        for (size_t t = 0; t < bad.size(); ++t)
+            if (bad[t])
+                for (size_t k = 0; k < 3; ++k)
+                    vertex[mesh_.Vertex(t, k)] = 1;
+
+        size_t count = 0;
+        for (size_t t = 0; t < tiles_.size(); ++t) {
+            const Index* tri = &triangles_[3 * t];
+            if (vertex[tri[0]] || vertex[tri[1]] || vertex[tri[2]])
+                continue;
+            std::copy(tri, tri + 3, triangles_.begin() + 3 * count);
+            tiles_[count++] = tiles_[t];
+        }
+        triangles_.resize(3 * count);
+        tiles_.resize(count);
+    }
+
+    // returns false if some triangles were uncertified, so stitching must be repeated
+    bool StitchOnce(size_t threads) {
+        BuildCertified();
+        size_t certified = mesh_.TrianglesCount();
+        std::vector<char> bad(certified, 0);
+        if (!CheckTopology(bad) || !CheckSeams(bad, threads)) {
+            Uncertify(bad);
+            return false;
+        }
+
+        // the seams are triangulated by the points on their boundary and the unused points
+        std::vector<Index> local(points_.size(), NONE);
+        std::vector<Index> ids;
+        std::vector<Pnt> points;
+        for (size_t v = 0; v < points_.size(); ++v) {
+            bool used = mesh_.VertexEdge(v) != NONE;
+            bool border = false;
+            if (used) {
+                for (Index h: mesh_.OutgoingEdges(v)) {
+                    border = mesh_.Twin(h) == NONE;
+                    break;
+                }
+            }
+            if (border || (!used && !duplicate_[v])) {
+                local[v] = static_cast<Index>(ids.size());
+                ids.push_back(static_cast<Index>(v));
+                points.push_back(points_[v]);
+            }
+        }
+        seam_points_ = ids.size();
+
+        Delaunay<Tp, Index> seam(points);
+        const Mesh& seam_mesh = seam.GetMesh();
+
+        // seam triangles behind the certified boundary are the seeds of the fill,
+        // the boundary edges are its walls; a boundary edge missing in the seam
+        // triangulation is allowed on the convex hull only
+        std::vector<char> wall(seam_mesh.Triangles().size(), 0);
+        std::vector<char> filled(seam_mesh.TrianglesCount(), 0);
+        std::vector<Index> stack;
+        bool ok = true;
+        for (size_t h = 0; h < mesh_.Triangles().size(); ++h) {
+            if (mesh_.Twin(h) != NONE)
+                continue;
+
+            Index from = local[mesh_.Origin(h)];
+            Index to = local[mesh_.Target(h)];
+            Index inner = NONE, outer = NONE;
+            for (Index e: seam_mesh.OutgoingEdges(to))
+                if (seam_mesh.Target(e) == from)
+                    outer = e;
+            for (Index e: seam_mesh.OutgoingEdges(from))
+                if (seam_mesh.Target(e) == to)
+                    inner = e;
+
+            if (outer != NONE) {
+                wall[outer] = 1;
+                if (!filled[outer / 3]) {
+                    filled[outer / 3] = 1;
+                    stack.push_back(outer / 3);
+                }
+            } else if (inner == NONE || seam_mesh.Twin(inner) != NONE) {
+                bad[h / 3] = 1;
+                ok = false;
+            }
+        }
+        if (!ok) {
+            Uncertify(bad);
+            return false;
+        }
+
+        if (certified == 0) {
+            for (size_t t = 0; t < seam_mesh.TrianglesCount(); ++t) {
+                filled[t] = 1;
+                stack.push_back(t);
+            }
+        }
+        while (!stack.empty()) {
+            Index t = stack.back();
+            stack.pop_back();
+            mesh_.AddTriangle(ids[seam_mesh.Vertex(t, 0)], ids[seam_mesh.Vertex(t, 1)],
+                              ids[seam_mesh.Vertex(t, 2)]);
+            for (Index h = 3 * t; h < 3 * t + 3; ++h) {
+                Index twin = seam_mesh.Twin(h);
+                if (!wall[h] && twin != NONE && !filled[twin / 3]) {
+                    filled[twin / 3] = 1;
+                    stack.push_back(twin / 3);
+                }
+            }
+        }
+        mesh_.BuildAdjacency();
+        origins_.resize(mesh_.TrianglesCount(), SEAM);
+
+        bad.assign(mesh_.TrianglesCount(), 0);
+        if (certified == 0)
+            return true;
+        if (!CheckTopology(bad) || !CheckSeams(bad, threads)) {
+            bad.resize(certified);
+            if (std::find(bad.begin(), bad.end(), 1) == bad.end())
+                bad.assign(certified, 1);
+            Uncertify(bad);
+            return false;
+        }
+        if (!CheckBoundary()) {
+            triangles_.clear();
+            tiles_.clear();
+            return false;
+        }
+        return true;
+    }
+
+private:
+    const std::vector<Pnt>& points_;
+    std::vector<size_t> starts_;
+    std::vector<size_t> bucket_;
+    std::vector<char> duplicate_;
+    TileHeader header_;
+    double halo_;
+
+    // certified triangles and their tiles
+    std::vector<Index> triangles_;
+    std::vector<size_t> tiles_;
+
+    Mesh mesh_;
+    std::vector<size_t> origins_;
+    size_t seam_points_;
+};
+
+template<typename Tp, typename Index>
+const Index TiledDelaunay<Tp, Index>::NONE;
+
+template<typename Tp, typename Index>
+const size_t TiledDelaunay<Tp, Index>::SEAM;
+
+// triangulates `points` by tiles exchanged through files "tile_<i>.in" and "tile_<i>.out"
+// in `dir`, `run(in, out)` must write the result of `TriangulateTile` for tile file `in`
+// into file `out`, e.g. by a worker process
+//
+//     [] (const std::string& in, const std::string& out) {
+//         std::system(("./tile_worker < " + in + " > " + out).c_str());
+//     }
+//
+// up to `threads` tiles are written and run at once
+// returns false if results of some tiles were lost, the mesh is complete anyway
+template<typename Tp, typename Index, typename Func>
+bool TriangulateTiles(const std::vector<Point<Tp, 2>>& points, size_t tiles_x, size_t tiles_y,
+                      double halo, const std::string& dir, Func run, TriangleMesh<Index>& mesh,
+                      size_t threads = 1)
+{
+    TiledDelaunay<Tp, Index> tiled(points, tiles_x, tiles_y, halo);
+    auto path = [&dir] (size_t tile, const char* ext) {
+        return dir + "/tile_" + std::to_string(tile) + ext;
+    };
+
+    ParallelFor(tiled.TilesCount(), threads, [&] (size_t tile) {
+        {
+            std::ofstream out(path(tile, ".in"), std::ios::binary);
+            tiled.WriteTile(tile, out);
+        }
+        run(path(tile, ".in"), path(tile, ".out"));
+    });
+
+    bool ok = true;
+    for (size_t tile = 0; tile < tiled.TilesCount(); ++tile) {
+        std::ifstream in(path(tile, ".out"), std::ios::binary);
+        ok &= tiled.ReadResult(tile, in);
+    }
+
+    tiled.Stitch(threads);
+    mesh = tiled.GetMesh();
+    return ok;
+}
+
+} // namespace geometry
+
+#endif // TILED_DELAUNAY_H
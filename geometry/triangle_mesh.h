@@ -0,0 +1,379 @@
+#ifndef TRIANGLE_MESH_H
+#define TRIANGLE_MESH_H
+#include <iostream>
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <algorithm>
+
+namespace geometry {
+
+namespace detail {
+
+// reads `count` values of trivially copyable T into `data`, which grows by blocks
+// as the input arrives, so a broken count fails at the end of input instead of allocating
+template<typename T>
+bool ReadArray(std::istream& in, std::vector<T>& data, uint64_t count) {
+    const uint64_t BLOCK = 1 << 16;
+
+    data.clear();
+    while (data.size() < count) {
+        size_t size = data.size();
+        size_t block = static_cast<size_t>(std::min(BLOCK, count - size));
+        data.resize(size + block);
+        if (!in.read(reinterpret_cast<char*>(data.data() + size), block * sizeof(T)))
+            return false;
+    }
+    return true;
+}
+
+} // namespace detail
+
+// indexed triangle mesh with half-edge adjacency
+//
+// triangle `t` consists of vertices 3t, 3t + 1, 3t + 2 in counterclockwise order
+// half-edge `h` goes from vertex `h` to vertex `Next(h)` of the same triangle,
+// its twin is the same edge in the neighbour triangle or NONE on the boundary
+// use `TriangleMesh<uint64_t>` for meshes with more than 2^32 - 1 half-edges
+template<typename Index = uint32_t>
+class TriangleMesh {
+public:
+    static const Index NONE = static_cast<Index>(-1);
+
+    class RingIterator;
+
+    struct Ring {
+        RingIterator begin() const {
+            return RingIterator(mesh, start);
+        }
+
+        RingIterator end() const {
+            return RingIterator(mesh, NONE);
+        }
+
+        const TriangleMesh* mesh;
+        Index start;
+    };
+
+public:
+    TriangleMesh() {}
+
+    explicit TriangleMesh(size_t vertices)
+        : vertex_edge_(vertices, NONE)
+    {}
+
+    void Clear() {
+        vertices_.clear();
+        twins_.clear();
+        vertex_edge_.clear();
+    }
+
+    void Reserve(size_t triangles) {
+        vertices_.reserve(3 * triangles);
+        twins_.reserve(3 * triangles);
+    }
+
+    // sets count of triangles, new triangles must be filled by `SetTriangle`
+    void ResizeTriangles(size_t triangles) {
+        vertices_.resize(3 * triangles, NONE);
+        twins_.resize(3 * triangles, NONE);
+    }
+
+    // `vertices` - upper bound of vertex ids
+    void ResizeVertices(size_t vertices) {
+        vertex_edge_.resize(vertices, NONE);
+    }
+
+    // appends triangle without neighbours, returns its id
+    Index AddTriangle(Index a, Index b, Index c) {
+        vertices_.resize(vertices_.size() + 3);
+        twins_.resize(twins_.size() + 3, NONE);
+
+        Index t = static_cast<Index>(TrianglesCount() - 1);
+        SetTriangle(t, a, b, c);
+        return t;
+    }
+
+    // replaces vertices of triangle `t`, neighbours stay untouched
+    void SetTriangle(Index t, Index a, Index b, Index c) {
+        assert(a < vertex_edge_.size() && b < vertex_edge_.size() && c < vertex_edge_.size());
+
+        vertices_[3 * t] = a;
+        vertices_[3 * t + 1] = b;
+        vertices_[3 * t + 2] = c;
+        vertex_edge_[a] = 3 * t;
+        vertex_edge_[b] = 3 * t + 1;
+        vertex_edge_[c] = 3 * t + 2;
+    }
+
+    // moves triangle `from` with its adjacency to the unused slot `to`
+    void MoveTriangle(Index from, Index to) {
+        SetTriangle(to, vertices_[3 * from], vertices_[3 * from + 1], vertices_[3 * from + 2]);
+        for (Index k = 0; k < 3; ++k)
+            SetTwin(3 * to + k, twins_[3 * from + k]);
+    }
+
+    // makes `h` the half-edge returned by `VertexEdge(v)`, NONE marks `v` unused
+    void SetVertexEdge(size_t v, Index h) {
+        assert(h == NONE || vertices_[h] == v);
+        vertex_edge_[v] = h;
+    }
+
+    // makes `h` and `g` twins, `g` may be NONE
+    void SetTwin(Index h, Index g) {
+        twins_[h] = g;
+        if (g != NONE)
+            twins_[g] = h;
+    }
+
+    // recomputes twins from vertex triples
+    // half-edges are bucketed by origin, so no hashing is involved
+    void BuildAdjacency() {
+        std::vector<Index> offsets(VerticesCount() + 1, 0);
+        for (Index v: vertices_)
+            ++offsets[v + 1];
+        for (size_t v = 0; v < VerticesCount(); ++v)
+            offsets[v + 1] += offsets[v];
+
+        std::vector<Index> outgoing(vertices_.size());
+        std::vector<Index> pos(offsets.begin(), offsets.end() - 1);
+        for (size_t h = 0; h < vertices_.size(); ++h)
+            outgoing[pos[vertices_[h]]++] = static_cast<Index>(h);
+
+        twins_.assign(vertices_.size(), NONE);
+        for (size_t h = 0; h < vertices_.size(); ++h) {
+            Index from = vertices_[h];
+            Index to = vertices_[Next(h)];
+            for (Index i = offsets[to]; i < offsets[to + 1]; ++i) {
+                if (vertices_[Next(outgoing[i])] == from) {
+                    twins_[h] = outgoing[i];
+                    break;
+                }
+            }
+        }
+    }
+
+    // binary format: "TMSH", size of Index, counts of vertices and triangles as uint64_t,
+    // then vertex triples and `VertexEdge` of every vertex; byte order is native,
+    // twins aren't stored
+    void WriteBinary(std::ostream& out) const {
+        uint64_t header[3] = {sizeof(Index), VerticesCount(), TrianglesCount()};
+        out.write("TMSH", 4);
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(vertices_.data()), vertices_.size() * sizeof(Index));
+        out.write(reinterpret_cast<const char*>(vertex_edge_.data()), vertex_edge_.size() * sizeof(Index));
+    }
+
+    // reads the format of `WriteBinary` and rebuilds adjacency
+    // returns false and leaves the mesh empty if the input is truncated, inconsistent
+    // or isn't a mesh with the same Index; memory is taken only for the data actually read
+    bool ReadBinary(std::istream& in) {
+        char magic[4];
+        uint64_t header[3];
+        Clear();
+        if (!in.read(magic, 4) || std::memcmp(magic, "TMSH", 4) != 0)
+            return false;
+        if (!in.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0] != sizeof(Index))
+            return false;
+        // ids of vertices and half-edges must fit Index
+        if (header[1] > NONE || header[2] > NONE / 3)
+            return false;
+
+        if (!detail::ReadArray(in, vertices_, 3 * header[2]) ||
+            !detail::ReadArray(in, vertex_edge_, header[1]) || !Consistent()) {
+            Clear();
+            return false;
+        }
+        BuildAdjacency();
+        return true;
+    }
+
+    size_t TrianglesCount() const {
+        return vertices_.size() / 3;
+    }
+
+    size_t VerticesCount() const {
+        return vertex_edge_.size();
+    }
+
+    // returns vertex `k` of triangle `t`
+    Index Vertex(size_t t, size_t k) const {
+        assert(k < 3);
+        return vertices_[3 * t + k];
+    }
+
+    // returns vertex, where half-edge `h` starts
+    Index Origin(size_t h) const {
+        return vertices_[h];
+    }
+
+    // returns vertex, where half-edge `h` ends
+    Index Target(size_t h) const {
+        return vertices_[Next(h)];
+    }
+
+    Index Twin(size_t h) const {
+        return twins_[h];
+    }
+
+    // returns triangle, which lies across half-edge `h`, or NONE
+    Index Neighbour(size_t h) const {
+        return twins_[h] == NONE ? NONE : twins_[h] / 3;
+    }
+
+    // returns some half-edge outgoing from vertex `v`, NONE if `v` isn't used
+    Index VertexEdge(size_t v) const {
+        return vertex_edge_[v];
+    }
+
+    // vertex triples, see class description
+    const std::vector<Index>& Triangles() const {
+        return vertices_;
+    }
+
+    const std::vector<Index>& Twins() const {
+        return twins_;
+    }
+
+    static Index Next(size_t h) {
+        return static_cast<Index>(h % 3 == 2 ? h - 2 : h + 1);
+    }
+
+    static Index Prev(size_t h) {
+        return static_cast<Index>(h % 3 == 0 ? h + 2 : h - 1);
+    }
+
+    // returns boundary half-edge, which starts at the end of boundary half-edge `h`
+    Index NextBoundary(Index h) const {
+        assert(twins_[h] == NONE);
+        Index e = Next(h);
+        while (twins_[e] != NONE)
+            e = Next(twins_[e]);
+        return e;
+    }
+
+    // returns boundary half-edge, which ends at the start of boundary half-edge `h`
+    Index PrevBoundary(Index h) const {
+        assert(twins_[h] == NONE);
+        Index e = Prev(h);
+        while (twins_[e] != NONE)
+            e = Prev(twins_[e]);
+        return e;
+    }
+
+    // half-edges outgoing from vertex `v` in counterclockwise order
+    // for boundary vertices iteration starts from the boundary half-edge
+    Ring OutgoingEdges(size_t v) const {
+        Index start = vertex_edge_[v];
+        if (start == NONE)
+            return Ring{this, NONE};
+
+        // rotate clockwise up to the boundary
+        Index e = start;
+        while (twins_[e] != NONE) {
+            e = Next(twins_[e]);
+            if (e == start)
+                break;
+        }
+
+        return Ring{this, e};
+    }
+
+    // calls `func(u)` for every vertex `u` adjacent to vertex `v`
+    template<typename Func>
+    void ForEachNeighbour(size_t v, Func func) const {
+        for (Index h: OutgoingEdges(v)) {
+            func(Target(h));
+            if (twins_[Prev(h)] == NONE)
+                func(Origin(Prev(h)));
+        }
+    }
+
+private:
+    // vertex ids are in range, `VertexEdge` of a vertex starts at it
+    bool Consistent() const {
+        for (Index v: vertices_)
+            if (v >= VerticesCount())
+                return false;
+        for (size_t v = 0; v < VerticesCount(); ++v)
+            if (vertex_edge_[v] != NONE &&
+                (vertex_edge_[v] >= vertices_.size() || vertices_[vertex_edge_[v]] != v))
+                return false;
+        return true;
+    }
+
+private:
+    std::vector<Index> vertices_;
+    std::vector<Index> twins_;
+    std::vector<Index> vertex_edge_;
+};
+
+template<typename Index>
+const Index TriangleMesh<Index>::NONE;
+
+template<typename Index>
+class TriangleMesh<Index>::RingIterator {
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef Index value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const Index* pointer;
+    typedef Index reference;
+
+public:
+    RingIterator(const TriangleMesh* mesh, Index start)
+        : mesh_(mesh)
+        , start_(start)
+        , cur_(start)
+    {}
+
+    Index operator*() const {
+        return cur_;
+    }
+
+    RingIterator& operator++() {
+        cur_ = mesh_->Twin(Prev(cur_));
+        if (cur_ == start_)
+            cur_ = NONE;
+        return *this;
+    }
+
+    RingIterator operator++(int) {
+        RingIterator res(*this);
+        ++(*this);
+        return res;
+    }
+
+    bool operator==(const RingIterator& oth) const {
+        return cur_ == oth.cur_;
+    }
+
+    bool operator!=(const RingIterator& oth) const {
+        return cur_ != oth.cur_;
+    }
+
+private:
+    const TriangleMesh* mesh_;
+    Index start_;
+    Index cur_;
+};
+
+template<typename Index>
+std::ostream& operator << (std::ostream& out, const TriangleMesh<Index>& mesh) {
+    using std::endl;
+
+    out << "[TRIANGLES]" << endl;
+    out << mesh.TrianglesCount() << endl;
+    for (size_t t = 0; t < mesh.TrianglesCount(); ++t) {
+        out << mesh.Vertex(t, 0) + 1 << " "
+            << mesh.Vertex(t, 1) + 1 << " "
+            << mesh.Vertex(t, 2) + 1 << endl;
+    }
+    return out;
+}
+
+} // namespace geometry
+
+#endif // TRIANGLE_MESH_H
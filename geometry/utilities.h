@@ -1,6 +1,9 @@
 #ifndef UTILITIES_H
 #define UTILITIES_H
 #include "polygon.h"
+#include "triangle_mesh.h"
+#include "parallel.h"
+#include "pipeline.h"
 #include <limits>
 #include <vector>
 #include <set>
@@ -35,96 +38,133 @@ double Distance(const Polygon<Tp, 2>& poly1, const Polygon<Tp, 2>& poly2) {
     return min_dist;
 }
 
+// batch version of `Polygon::Validate`, blocks of polygons are taken by `threads` dynamically
 template<typename Tp>
-std::pair<int, int> FindIntersection(std::vector<Segment<Tp>>& segments) {
-    using namespace std;
-
-    struct Event {
-        Event(Tp x, int ev, int id)
-            : x(x)
-            , ev(ev)
-            , id(id)
-        {}
-
-        bool operator<(const Event& oth) const {
-            return (x < oth.x) || (x == oth.x && ev > oth.ev);
-        }
+std::vector<Validity> Validate(const std::vector<Polygon<Tp>>& polygons, size_t threads = 1) {
+    std::vector<Validity> res(polygons.size());
+    ParallelBlocks(polygons.size(), threads, 64, [&] (size_t, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            res[i] = polygons[i].Validate();
+    });
+    return res;
+}
 
-        Tp x;
-        int ev;
-        int id;
-    };
-
-    vector<Event> events;
-    for (size_t i = 0; i < segments.size(); ++i) {
-        Segment<Tp>& s = segments[i];
-        s.Reorder();
-        events.push_back(Event(s.p1_.x(), 1, i));
-        events.push_back(Event(s.p2_.x(), -1, i));
+// triangulates `count` polygons starting from `polygons` into one `mesh`
+// triangles of polygons[i] are offsets[i], ..., offsets[i + 1] - 1 and vertex `k` of it
+// has id k + (sizes of the preceding polygons), twins don't cross polygons
+// blocks of polygons are taken by `threads` dynamically, list nodes of every thread
+// live in its own arena
+// returns ids of polygons ear clipping couldn't finish (they aren't simple), such polygons
+// get fewer than size - 2 triangles, the mesh has no empty slots
+template<typename Tp, typename Index>
+std::vector<size_t> TriangulateBatch(const Polygon<Tp>* polygons, size_t count,
+                                     TriangleMesh<Index>& mesh, std::vector<size_t>& offsets,
+                                     size_t threads = 0)
+{
+    const Index NONE = TriangleMesh<Index>::NONE;
+
+    offsets.assign(count + 1, 0);
+    for (size_t i = 0; i < count; ++i) {
+        assert(polygons[i].Size() >= 3);
+        offsets[i + 1] = offsets[i] + polygons[i].Size() - 2;
     }
-    sort(events.begin(), events.end());
-
-    struct Seg {
-        Seg(Segment<Tp>* s, int id)
-            : s(s)
-            , id(id)
-        {}
-
-        double y(const Segment<Tp>& s, Tp x) const {
-            Tp x1 = s.p1_.x();
-            Tp x2 = s.p2_.x();
-            Tp y1 = s.p1_.y();
-            Tp y2 = s.p2_.y();
-
-            if (x1 == x2) return y1;
-            return y1 + ((y2 - y1) * (x - x1) * 1.0) / (x2 - x1);
-        }
 
-        bool operator<(const Seg& seg) const {
-            Segment<Tp>& s1 = *s;
-            Segment<Tp>& s2 = *seg.s;
-
-            int max_x = max(s1.p1_.x(), s2.p1_.x());
-            return y(s1, max_x) < y(s2, max_x);
-        }
-
-        Segment<Tp>* s;
-        int id;
-    };
-
-    set<Seg> s;
-    vector<typename set<Seg>::iterator> where(segments.size());
-
-    for (const auto& e: events) {
-        if (e.ev == 1) {
-            auto& seg = segments[e.id];
-            
-            auto n = s.lower_bound(Seg(&seg, e.id));
-            if (n != s.end() && seg.Intersected(*n->s)) {
-                    return {e.id, n->id};
-            }
-
-            if (n != s.begin()) {
-                auto p = prev(n);
-                if (seg.Intersected(*p->s)) {
-                    return {e.id, p->id};
+    // every polygon has two vertices more than triangles
+    mesh.Clear();
+    mesh.ResizeVertices(offsets[count] + 2 * count);
+    mesh.ResizeTriangles(offsets[count]);
+
+    std::vector<size_t> produced(count);
+    ParallelBlocks(count, threads, 256, [&] (size_t, size_t begin, size_t end) {
+        TriangleMesh<Index> local;
+        for (size_t i = begin; i < end; ++i) {
+            polygons[i].Triangulation(local);
+            produced[i] = local.TrianglesCount();
+
+            Index first = static_cast<Index>(offsets[i]);
+            Index base = static_cast<Index>(offsets[i] + 2 * i);
+            for (size_t t = 0; t < local.TrianglesCount(); ++t) {
+                mesh.SetTriangle(first + t, base + local.Vertex(t, 0),
+                                 base + local.Vertex(t, 1), base + local.Vertex(t, 2));
+                for (size_t k = 0; k < 3; ++k) {
+                    Index twin = local.Twin(3 * t + k);
+                    if (twin != NONE)
+                        mesh.SetTwin(3 * (first + t) + k, 3 * first + twin);
                 }
             }
-
-            where[e.id] = s.insert(n, Seg(&seg, e.id));
-        } else {
-            assert(e.ev == -1);
-            auto n = s.erase(where[e.id]);
-            if (n != s.end() && n != s.begin()) {
-                auto p = prev(n);
-                if (n->s->Intersected(*p->s)) {
-                    return {n->id, p->id};
-                }
+        }
+    });
+
+    // triangles of the following polygons are moved into the unused slots,
+    // a twin is linked when the later of two half-edges is moved
+    std::vector<size_t> failed;
+    size_t used = 0;
+    for (size_t i = 0; i < count; ++i) {
+        size_t first = offsets[i];
+        offsets[i] = used;
+        if (produced[i] < polygons[i].Size() - 2)
+            failed.push_back(i);
+
+        Index shift = static_cast<Index>(3 * (first - used));
+        for (size_t t = 0; shift != 0 && t < produced[i]; ++t) {
+            Index from = static_cast<Index>(first + t);
+            Index to = static_cast<Index>(used + t);
+            mesh.SetTriangle(to, mesh.Vertex(from, 0), mesh.Vertex(from, 1), mesh.Vertex(from, 2));
+            for (Index k = 0; k < 3; ++k) {
+                Index twin = mesh.Twin(3 * from + k);
+                if (twin != NONE && twin - shift < 3 * to + k)
+                    mesh.SetTwin(3 * to + k, twin - shift);
+                else
+                    mesh.SetTwin(3 * to + k, NONE);
             }
         }
+        used += produced[i];
     }
+    offsets[count] = used;
+    mesh.ResizeTriangles(used);
+    return failed;
+}
+
+template<typename Tp, typename Index>
+std::vector<size_t> TriangulateBatch(const std::vector<Polygon<Tp>>& polygons,
+                                     TriangleMesh<Index>& mesh, std::vector<size_t>& offsets,
+                                     size_t threads = 0)
+{
+    return TriangulateBatch(polygons.data(), polygons.size(), mesh, offsets, threads);
+}
 
-    return {-1, -1};
+// reads polygons from `in` until the end of input, triangulates them by chunks of `chunk`
+// polygons and writes the mesh of every chunk into `out`
+// reading, triangulation and writing of neighbour chunks overlap, at most a few chunks
+// are kept in memory
+template<typename Tp, typename Index = uint32_t>
+void TriangulateStream(std::istream& in, std::ostream& out, size_t chunk = 1024, size_t threads = 1)
+{
+    typedef std::vector<Polygon<Tp>> Chunk;
+
+    Pipeline pipeline(2);
+    auto chunks = pipeline.Source<Chunk>([&in, chunk] (Chunk& polygons) {
+        polygons.clear();
+        while (polygons.size() < chunk) {
+            Polygon<Tp> polygon;
+            if (!(in >> polygon))
+                break;
+            polygons.push_back(std::move(polygon));
+        }
+        return !polygons.empty();
+    });
+
+    auto meshes = pipeline.Stage(chunks, [threads] (Chunk polygons) {
+        TriangleMesh<Index> mesh;
+        std::vector<size_t> offsets;
+        TriangulateBatch(polygons, mesh, offsets, threads);
+        return mesh;
+    });
+
+    pipeline.Sink(meshes, [&out] (TriangleMesh<Index> mesh) {
+        out << mesh;
+    });
+    pipeline.Wait();
 }
 
 } // namespace geometry
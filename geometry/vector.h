@@ -32,18 +32,17 @@ struct all_true<>
 template<typename Tp, size_t dim = 2> 
 class Vector {
 public:
-    const size_t sz = dim;
+    static constexpr size_t dimension = dim;
 
 private:
     typedef Vector<Tp, dim> Vec;
     typedef Point<Tp, dim> Pnt;
 
 public: 
-    Vector() {
-        memset(coordinates_, 0, sizeof(coordinates_));
-    }
+    constexpr Vector()
+        : coordinates_()
+    {}
 
-        
     template<class...CoordinateType, typename = typename 
         std::enable_if<
             all_true<
@@ -53,10 +52,11 @@ public:
             >::value
         >::type
     >
-    Vector(CoordinateType ... coordinates) {
+    constexpr Vector(CoordinateType ... coordinates)
+        : coordinates_{coordinates...}
+    {
         static_assert(sizeof...(CoordinateType) == dim, 
                 "count of coordinates must be equal to count of dimensions of Vector");
-        Init(0, coordinates...);
     }
 
     Vector(const Pnt& beg, const Pnt& end) {
@@ -69,10 +69,6 @@ public:
         *this = pnt;
     }
 
-    Vector(const Vec& oth) {
-        *this = oth;
-    }
-
     // sometimes you can't calculate `Length`
     // due to `sqrt` works with not all types (e.g. `mpq_class` doesn't support `sqrt`)
     // use `Length2` in this case, which returns Length ^ 2 and you'll need calculate `sqrt` by hands
@@ -112,8 +108,8 @@ public:
 
     Vector<Tp, 3> CrossProduct(const Vec& oth) const {
         assert(dim >= 2 && dim <= 3); // =(
-        Tp* first = coordinates_;
-        Tp* second = oth.coordinates_;
+        const Tp* first = coordinates_;
+        const Tp* second = oth.coordinates_;
 
         Vector<Tp, 3> result;
         if (dim == 3) {
@@ -149,11 +145,6 @@ public:
         return Vec(-coordinates_[1], coordinates_[0]);
     }
 
-    Vec& operator=(const Vec& oth) {
-        Assign(oth);
-        return *this;
-    }
-
     template<typename U>
     Vector<Tp, dim>& operator=(const Point<U, dim>& oth) {
         Assign(oth);
@@ -200,19 +191,6 @@ private:
             coordinates_[i] = static_cast<U>(oth.coordinates_[i]);
     }
 
-    template<class FirstCoordinateType, class...CoordinateType>
-    void Init(int lev, FirstCoordinateType first, CoordinateType...coordinates) {
-        static_assert(std::is_convertible<FirstCoordinateType, Tp>::value,
-                "types must be convertible to Tp");
-
-        coordinates_[lev] = static_cast<Tp>(first);
-        Init(lev + 1, coordinates...);
-    }
-
-    void Init(int lev) {
-        assert(lev == dim);
-    }
-
     template<typename T>
     inline static int Sign(T val) {
         return (T(0) < val) - (val < T(0));
@@ -245,6 +223,9 @@ private:
     friend std::istream& operator >> (std::istream& in, Vector<T, d>& vector);
 };
 
+template<typename Tp, size_t dim>
+constexpr size_t Vector<Tp, dim>::dimension;
+
 template<typename Tp, size_t dim = 2>
 std::ostream& operator << (std::ostream& out, const Vector<Tp, dim>& vector) {
     for (const Tp& x: vector.coordinates_) {
@@ -0,0 +1,186 @@
+#ifndef VORONOI_H
+#define VORONOI_H
+#include <vector>
+#include <cassert>
+#include <algorithm>
+#include <cstdint>
+#include "point.h"
+#include "vector.h"
+#include "circle.h"
+#include "polygon.h"
+#include "triangle_mesh.h"
+#include "delaunay.h"
+#include "parallel.h"
+
+namespace geometry {
+
+// Voronoi diagram as the dual of Delaunay triangulation
+// vertex `t` is the circumcenter of triangle `t`, cell `v` belongs to site `v`
+// cells are stored in flat arrays: vertices of cell `v` are
+// Cell(v)[0], ..., Cell(v)[CellSize(v) - 1] in counterclockwise order
+// cells of hull sites are unbounded: the chain is open and both its ends go to infinity
+// `mesh` must outlive the diagram
+template<typename Tp, typename Index = uint32_t>
+class VoronoiDiagram {
+public:
+    typedef Point<double, 2> Pnt;
+
+private:
+    typedef TriangleMesh<Index> Mesh;
+
+public:
+    explicit VoronoiDiagram(const Delaunay<Tp, Index>& mesh, size_t threads = 1)
+        : mesh_(mesh)
+        , topology_(mesh.GetMesh())
+    {
+        const std::vector<Index>& triangles = topology_.Triangles();
+
+        offsets_.assign(mesh_.PointsCount() + 1, 0);
+        for (Index v: triangles)
+            ++offsets_[v + 1];
+        for (size_t v = 0; v < mesh_.PointsCount(); ++v)
+            offsets_[v + 1] += offsets_[v];
+
+        vertices_.resize(mesh_.TrianglesCount());
+        ParallelFor(mesh_.TrianglesCount(), threads, [this] (size_t t) {
+            vertices_[t] = Circumcenter(mesh_.GetPoint(topology_.Vertex(t, 0)),
+                                        mesh_.GetPoint(topology_.Vertex(t, 1)),
+                                        mesh_.GetPoint(topology_.Vertex(t, 2)));
+        });
+
+        // triangle of every outgoing half-edge lies counterclockwise from it
+        cells_.resize(triangles.size());
+        bounded_.assign(mesh_.PointsCount(), false);
+        ParallelFor(mesh_.PointsCount(), threads, [this] (size_t v) {
+            size_t pos = offsets_[v];
+            for (Index h: topology_.OutgoingEdges(v)) {
+                if (pos == offsets_[v])
+                    bounded_[v] = topology_.Twin(h) != Mesh::NONE;
+                cells_[pos++] = h / 3;
+            }
+        });
+    }
+
+    size_t CellsCount() const {
+        return offsets_.size() - 1;
+    }
+
+    size_t CellSize(size_t v) const {
+        return offsets_[v + 1] - offsets_[v];
+    }
+
+    const Index* Cell(size_t v) const {
+        return cells_.data() + offsets_[v];
+    }
+
+    bool Bounded(size_t v) const {
+        return bounded_[v];
+    }
+
+    const std::vector<Pnt>& Vertices() const {
+        return vertices_;
+    }
+
+    // clips every cell by convex counterclockwise polygon `bounds`
+    // cell `v` of the result is points[offsets[v]], ..., points[offsets[v + 1] - 1]
+    void Clip(const Polygon<double>& bounds, std::vector<Pnt>& points,
+              std::vector<size_t>& offsets, size_t threads = 1) const
+    {
+        assert(bounds.Size() >= 3 && bounds.CounterclockwiseOrder());
+
+        size_t chunks = ThreadsCount(threads, CellsCount());
+        std::vector<std::vector<Pnt>> chunk_points(chunks);
+        offsets.assign(CellsCount() + 1, 0);
+
+        ParallelChunks(CellsCount(), chunks, [&] (size_t chunk, size_t begin, size_t end) {
+            std::vector<Pnt>& out = chunk_points[chunk];
+            std::vector<Pnt> cur, next;
+            out.reserve(offsets_[end] - offsets_[begin]);
+
+            for (size_t v = begin; v < end; ++v) {
+                size_t before = out.size();
+                if (CellSize(v) > 0 && !CopyInside(v, bounds, out)) {
+                    ClipCell(v, bounds, cur, next);
+                    out.insert(out.end(), cur.begin(), cur.end());
+                }
+                offsets[v + 1] = out.size() - before;
+            }
+        });
+
+        for (size_t v = 0; v < CellsCount(); ++v)
+            offsets[v + 1] += offsets[v];
+
+        points.clear();
+        points.reserve(offsets.back());
+        for (const auto& chunk: chunk_points)
+            points.insert(points.end(), chunk.begin(), chunk.end());
+    }
+
+private:
+    // bounded cells, which lie inside `bounds`, don't need clipping
+    bool CopyInside(size_t v, const Polygon<double>& bounds, std::vector<Pnt>& out) const {
+        if (!bounded_[v])
+            return false;
+
+        for (size_t k = 0; k < CellSize(v); ++k) {
+            if (bounds.CheckConvexInside(vertices_[Cell(v)[k]]) == OUTSIDE)
+                return false;
+        }
+
+        for (size_t k = 0; k < CellSize(v); ++k)
+            out.push_back(vertices_[Cell(v)[k]]);
+        return true;
+    }
+
+    // intersects `bounds` with half-planes of Delaunay neighbours of `v`
+    void ClipCell(size_t v, const Polygon<double>& bounds,
+                  std::vector<Pnt>& cur, std::vector<Pnt>& next) const
+    {
+        cur.clear();
+        for (size_t i = 0; i < bounds.Size(); ++i)
+            cur.push_back(bounds[i]);
+
+        Pnt site = mesh_.GetPoint(v);
+        topology_.ForEachNeighbour(v, [&] (Index u) {
+            ClipHalfPlane(site, mesh_.GetPoint(u), cur, next);
+        });
+    }
+
+    // leaves the part of `cur`, which is closer to `site` than to `oth`
+    static void ClipHalfPlane(const Pnt& site, const Pnt& oth,
+                              std::vector<Pnt>& cur, std::vector<Pnt>& next)
+    {
+        double nx = oth.x() - site.x();
+        double ny = oth.y() - site.y();
+        double mx = (oth.x() + site.x()) / 2;
+        double my = (oth.y() + site.y()) / 2;
+
+        next.clear();
+        for (size_t i = 0; i < cur.size(); ++i) {
+            const Pnt& p = cur[i];
+            const Pnt& q = cur[(i + 1) % cur.size()];
+            double fp = (p.x() - mx) * nx + (p.y() - my) * ny;
+            double fq = (q.x() - mx) * nx + (q.y() - my) * ny;
+
+            if (fp <= 0)
+                next.push_back(p);
+            if ((fp < 0 && fq > 0) || (fp > 0 && fq < 0)) {
+                double t = fp / (fp - fq);
+                next.push_back(Pnt(p.x() + (q.x() - p.x()) * t, p.y() + (q.y() - p.y()) * t));
+            }
+        }
+        cur.swap(next);
+    }
+
+private:
+    const Delaunay<Tp, Index>& mesh_;
+    const Mesh& topology_;
+    std::vector<Pnt> vertices_;
+    std::vector<size_t> offsets_;
+    std::vector<Index> cells_;
+    std::vector<char> bounded_;
+};
+
+} // namespace geometry
+
+#endif // VORONOI_H
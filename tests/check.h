@@ -0,0 +1,24 @@
+#ifndef CHECK_H
+#define CHECK_H
+#include <cstdio>
+
+// minimal checks: a failed one is reported and the test returns nonzero from `main`
+namespace test {
+
+inline int& Failures() {
+    static int failures = 0;
+    return failures;
+}
+
+inline void Fail(const char* file, int line, const char* expr) {
+    std::printf("%s:%d: check failed: %s\n", file, line, expr);
+    ++Failures();
+}
+
+} // namespace test
+
+#define CHECK(expr) ((expr) ? (void) 0 : test::Fail(__FILE__, __LINE__, #expr))
+
+#define TEST_RESULT() (test::Failures() == 0 ? 0 : 1)
+
+#endif // CHECK_H
@@ -0,0 +1,41 @@
+#include <cmath>
+#include "geometry/circle.h"
+#include "check.h"
+
+using namespace geometry;
+
+namespace {
+
+void TestRightTriangle() {
+    Point<int> a(0, 0), b(4, 0), c(0, 3);
+    CHECK(Circumcenter(a, b, c) == Point<double>(2, 1.5));
+    CHECK(Circumradius(a, b, c) == 2.5);
+    // the order of vertices doesn't matter
+    CHECK(Circumcenter(c, b, a) == Point<double>(2, 1.5));
+    CHECK(Circumradius(b, a, c) == 2.5);
+}
+
+// differences keep the precision of a small triangle far from the origin
+void TestFarFromOrigin() {
+    double base = std::ldexp(1.0, 30), side = std::ldexp(1.0, -10);
+    Point<double> a(base, base), b(base + side, base), c(base, base + side);
+    CHECK(Circumcenter(a, b, c) == Point<double>(base + side / 2, base + side / 2));
+    CHECK(std::abs(Circumradius(a, b, c) - side / std::sqrt(2.0)) < 1e-15);
+}
+
+void TestDegenerate() {
+    Point<double> a(0, 0), b(1, 1), c(2, 2);
+    Point<double> center = Circumcenter(a, b, c);
+    CHECK(!std::isfinite(center.x()) || !std::isfinite(center.y()));
+    CHECK(std::isinf(Circumradius(a, b, c)));
+    CHECK(std::isinf(Circumradius(a, a, a)));
+}
+
+} // namespace
+
+int main() {
+    TestRightTriangle();
+    TestFarFromOrigin();
+    TestDegenerate();
+    return TEST_RESULT();
+}
@@ -0,0 +1,175 @@
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include "geometry/clipping.h"
+#include "check.h"
+
+using namespace geometry;
+
+typedef std::vector<Polygon<double>> Rings;
+
+namespace {
+
+Polygon<double> Ring(std::initializer_list<double> coordinates) {
+    std::vector<Point<double>> points;
+    for (auto it = coordinates.begin(); it != coordinates.end(); it += 2)
+        points.push_back(Point<double>(*it, *(it + 1)));
+    return Polygon<double>(std::move(points));
+}
+
+// even-odd membership by a ray to the right
+bool Inside(const Rings& rings, double x, double y) {
+    bool inside = false;
+    for (const auto& ring: rings) {
+        for (size_t i = 0; i < ring.Size(); ++i) {
+            const Point<double>& a = ring[i];
+            const Point<double>& b = ring[(i + 1) % ring.Size()];
+            if ((a.y() > y) != (b.y() > y) && a.x() + (y - a.y()) * (b.x() - a.x()) / (b.y() - a.y()) > x)
+                inside = !inside;
+        }
+    }
+    return inside;
+}
+
+double Distance(const Rings& rings, double x, double y) {
+    double res = INFINITY;
+    for (const auto& ring: rings) {
+        for (size_t i = 0; i < ring.Size(); ++i) {
+            const Point<double>& a = ring[i];
+            const Point<double>& b = ring[(i + 1) % ring.Size()];
+            double dx = b.x() - a.x(), dy = b.y() - a.y();
+            double t = (x - a.x()) * dx + (y - a.y()) * dy;
+            t = dx == 0 && dy == 0 ? 0 : std::max(0.0, std::min(1.0, t / (dx * dx + dy * dy)));
+            res = std::min(res, std::hypot(a.x() + t * dx - x, a.y() + t * dy - y));
+        }
+    }
+    return res;
+}
+
+bool Expected(bool a, bool b, BooleanType op) {
+    switch (op) {
+        case INTERSECTION: return a && b;
+        case UNION: return a || b;
+        case DIFFERENCE: return a && !b;
+        default: return a != b;
+    }
+}
+
+// the result matches the operation on the even-odd membership of the operands at `samples`
+// points not too close to the input edges, its rings have distinct vertices and nonzero area
+bool Valid(const Rings& subject, const Rings& clip, BooleanType op, const Rings& res,
+           std::mt19937& gen, size_t samples)
+{
+    for (const auto& ring: res) {
+        std::vector<Point<double>> points;
+        double area = 0;
+        for (size_t i = 0; i < ring.Size(); ++i) {
+            const Point<double>& a = ring[i];
+            const Point<double>& b = ring[(i + 1) % ring.Size()];
+            area += a.x() * b.y() - a.y() * b.x();
+            points.push_back(a);
+        }
+        std::sort(points.begin(), points.end());
+        if (points.size() < 3 || area == 0 || std::unique(points.begin(), points.end()) != points.end())
+            return false;
+    }
+
+    double min_x = INFINITY, max_x = -INFINITY, min_y = INFINITY, max_y = -INFINITY;
+    for (const Rings* rings: {&subject, &clip}) {
+        for (const auto& ring: *rings) {
+            for (size_t i = 0; i < ring.Size(); ++i) {
+                min_x = std::min(min_x, ring[i].x());
+                max_x = std::max(max_x, ring[i].x());
+                min_y = std::min(min_y, ring[i].y());
+                max_y = std::max(max_y, ring[i].y());
+            }
+        }
+    }
+    std::uniform_real_distribution<double> ux(min_x - 1, max_x + 1), uy(min_y - 1, max_y + 1);
+    for (size_t i = 0; i < samples; ++i) {
+        double x = ux(gen), y = uy(gen);
+        if (Distance(subject, x, y) < 1e-6 || Distance(clip, x, y) < 1e-6)
+            continue;
+        if (Inside(res, x, y) != Expected(Inside(subject, x, y), Inside(clip, x, y), op))
+            return false;
+    }
+    return true;
+}
+
+// used to split an edge again and again behind the sweep and never finish
+void TestNoRecut() {
+    Rings subject{Ring({6, 4, 7, 1, 0, 1, 1, 2, 6, 6, 0, 4, 6, 6, 4, 5})};
+    Rings clip{Ring({2, 4, 0, 3, 2, 0, 6, 7, 2, 4, 7, 1, 3, 2, 2, 7, 2, 6})};
+    std::mt19937 gen(1);
+    for (int op = INTERSECTION; op <= XOR; ++op) {
+        Rings res = Boolean(subject, clip, static_cast<BooleanType>(op));
+        CHECK(Valid(subject, clip, static_cast<BooleanType>(op), res, gen, 2000));
+    }
+}
+
+// used to give wrong membership and sliver rings
+void TestDegenerateXor() {
+    Rings subject{Ring({1, 1, 7, 4, 3, 2}), Ring({3, 1, 5, 6, 6, 1, 2, 2, 4, 5, 3, 5, 7, 2})};
+    Rings clip{Ring({4, 7, 7, 5, 5, 6, 7, 4, 6, 0, 3, 6, 3, 5}), Ring({7, 1, 3, 7, 3, 2, 5, 6, 3, 3, 7, 1, 3, 4})};
+    Rings res = Boolean(subject, clip, XOR);
+    CHECK(Inside(res, 5.8151, 2.3333) == (Inside(subject, 5.8151, 2.3333) != Inside(clip, 5.8151, 2.3333)));
+    std::mt19937 gen(2);
+    CHECK(Valid(subject, clip, XOR, res, gen, 2000));
+}
+
+// integer vertices and intersections stay exact
+void TestExact() {
+    Rings a{Ring({0, 0, 4, 0, 4, 4, 0, 4})};
+    Rings b{Ring({2, 2, 6, 2, 6, 6, 2, 6})};
+    Rings res = Boolean(a, b, INTERSECTION);
+    CHECK(res.size() == 1);
+    if (res.size() == 1) {
+        std::vector<Point<double>> points;
+        for (size_t i = 0; i < res[0].Size(); ++i)
+            points.push_back(res[0][i]);
+        std::sort(points.begin(), points.end());
+        CHECK(points.size() == 4);
+        CHECK(points[0] == Point<double>(2, 2) && points[1] == Point<double>(2, 4));
+        CHECK(points[2] == Point<double>(4, 2) && points[3] == Point<double>(4, 4));
+    }
+
+    // touching at a vertex gives two rings
+    Rings c{Ring({4, 4, 8, 4, 8, 8, 4, 8})};
+    CHECK(Boolean(a, c, UNION).size() == 2);
+    CHECK(Boolean(a, c, INTERSECTION).empty());
+}
+
+// random rings with many coincident vertices and overlapping edges on a small grid
+void TestRandomGrid() {
+    std::mt19937 gen(3);
+    auto ring = [&gen] () {
+        std::vector<Point<double>> points(3 + gen() % 6);
+        for (auto& p: points)
+            p = Point<double>(gen() % 8, gen() % 8);
+        return Polygon<double>(std::move(points));
+    };
+
+    std::vector<Rings> subjects, clips;
+    for (int i = 0; i < 300; ++i) {
+        subjects.push_back(Rings{ring(), ring()});
+        clips.push_back(Rings{ring(), ring()});
+    }
+    for (int op = INTERSECTION; op <= XOR; ++op) {
+        auto res = Boolean(subjects, clips, static_cast<BooleanType>(op), 0);
+        size_t invalid = 0;
+        for (size_t i = 0; i < res.size(); ++i)
+            invalid += !Valid(subjects[i], clips[i], static_cast<BooleanType>(op), res[i], gen, 200);
+        CHECK(invalid == 0);
+    }
+}
+
+} // namespace
+
+int main() {
+    TestNoRecut();
+    TestDegenerateXor();
+    TestExact();
+    TestRandomGrid();
+    return TEST_RESULT();
+}
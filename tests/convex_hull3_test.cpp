@@ -0,0 +1,79 @@
+#include <vector>
+#include <random>
+#include "geometry/convex_hull3.h"
+#include "check.h"
+
+using namespace geometry;
+
+namespace {
+
+// a closed mesh of faces with no points above them
+template<typename Tp>
+bool Valid(const ConvexHull3<Tp>& hull, const std::vector<Point<Tp, 3>>& points) {
+    const auto& mesh = hull.GetMesh();
+    if (mesh.TrianglesCount() == 0)
+        return false;
+    for (size_t t = 0; t < mesh.TrianglesCount(); ++t) {
+        for (size_t h = 3 * t; h < 3 * t + 3; ++h) {
+            size_t twin = mesh.Twin(h);
+            if (twin == mesh.NONE || mesh.Twin(twin) != h || mesh.Origin(twin) != mesh.Target(h))
+                return false;
+        }
+        for (const auto& p: points) {
+            if (Orientation(points[mesh.Vertex(t, 0)], points[mesh.Vertex(t, 1)], points[mesh.Vertex(t, 2)], p) > 0)
+                return false;
+        }
+    }
+    return true;
+}
+
+// corners of a cube at the proven bound, random points inside and on its faces
+void TestIntegerCube() {
+    long long m = MaxOrientation3Coordinate();
+    std::vector<Point<long long, 3>> points;
+    for (int i = 0; i < 8; ++i)
+        points.push_back(Point<long long, 3>(i & 1 ? m : -m, i & 2 ? m : -m, i & 4 ? m : -m));
+
+    std::mt19937_64 gen(1);
+    std::uniform_int_distribution<long long> u(-m, m);
+    for (int i = 0; i < 200; ++i) {
+        long long c[3] = {u(gen), u(gen), u(gen)};
+        if (i % 2)
+            c[i % 3] = i % 4 == 1 ? m : -m;
+        points.push_back(Point<long long, 3>(c[0], c[1], c[2]));
+    }
+
+    ConvexHull3<long long> hull(points);
+    CHECK(Valid(hull, points));
+    CHECK(hull.Vertices() == std::vector<uint32_t>({0, 1, 2, 3, 4, 5, 6, 7}));
+    CHECK(hull.GetMesh().TrianglesCount() == 12);
+}
+
+void TestRandomDouble() {
+    std::mt19937 gen(2);
+    std::normal_distribution<double> u;
+    std::vector<Point<double, 3>> points;
+    for (int i = 0; i < 2000; ++i)
+        points.push_back(Point<double, 3>(u(gen), u(gen), u(gen)));
+
+    ConvexHull3<double> hull(points, 2);
+    CHECK(Valid(hull, points));
+}
+
+void TestDegenerate() {
+    std::vector<Point<int, 3>> points;
+    for (int i = 0; i < 10; ++i)
+        points.push_back(Point<int, 3>(i, 2 * i, i % 3));
+    points.push_back(Point<int, 3>(1, 2, 1));
+    ConvexHull3<int> flat(points);
+    CHECK(flat.GetMesh().TrianglesCount() == 0);
+}
+
+} // namespace
+
+int main() {
+    TestIntegerCube();
+    TestRandomDouble();
+    TestDegenerate();
+    return TEST_RESULT();
+}
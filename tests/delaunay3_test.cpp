@@ -0,0 +1,113 @@
+#include <vector>
+#include <random>
+#include <cmath>
+#include "geometry/delaunay3.h"
+#include "check.h"
+
+using namespace geometry;
+
+namespace {
+
+// finite tetrahedra are positive, have no points strictly inside their spheres
+// and fill the volume `volume`
+template<typename Tp>
+bool Valid(const Delaunay3<Tp>& delaunay, long double volume) {
+    const auto& points = delaunay.Points();
+    std::vector<uint32_t> tetrahedra = delaunay.FiniteTetrahedra();
+    long double sum = 0;
+    for (size_t t = 0; t < tetrahedra.size(); t += 4) {
+        const Point<Tp, 3>& a = points[tetrahedra[t]];
+        const Point<Tp, 3>& b = points[tetrahedra[t + 1]];
+        const Point<Tp, 3>& c = points[tetrahedra[t + 2]];
+        const Point<Tp, 3>& d = points[tetrahedra[t + 3]];
+        if (Orientation(a, b, c, d) <= 0)
+            return false;
+        for (const auto& p: points) {
+            if (InSphere(a, b, c, d, p) > 0)
+                return false;
+        }
+
+        long double diffs[9];
+        for (size_t i = 0; i < 3; ++i) {
+            diffs[i] = (long double) b.Get(i) - a.Get(i);
+            diffs[3 + i] = (long double) c.Get(i) - a.Get(i);
+            diffs[6 + i] = (long double) d.Get(i) - a.Get(i);
+        }
+        sum += detail::Orientation3Det()(diffs) / 6;
+    }
+    return std::abs(sum - volume) <= 1e-9L * volume;
+}
+
+// corners of the cube [-m, m]^3 and random points inside
+std::vector<Point<long long, 3>> Cube(long long m, size_t count, std::mt19937& gen) {
+    std::vector<Point<long long, 3>> points;
+    for (int i = 0; i < 8; ++i)
+        points.push_back(Point<long long, 3>(i & 1 ? m : -m, i & 2 ? m : -m, i & 4 ? m : -m));
+    std::uniform_int_distribution<long long> u(-m, m);
+    for (size_t i = 0; i < count; ++i)
+        points.push_back(Point<long long, 3>(u(gen), u(gen), u(gen)));
+    return points;
+}
+
+// the determinant overflows `long long` here
+void TestOrientation() {
+    long long m = (1 << 20) - 1;
+    Point<long long, 3> a(-m, -m, -m), b(m, m, -m), c(m, -m, m), d(-m, m, m);
+    CHECK(Orientation(a, b, c, d) == -1);
+    CHECK(Orientation(a, c, b, d) == 1);
+    CHECK(!Collinear(a, b, c));
+    CHECK(Collinear(a, Point<long long, 3>(0, 0, 0), Point<long long, 3>(m, m, m)));
+}
+
+// coordinates up to the proven bound used to break the pairing of new faces
+void TestIntegerCube() {
+    std::mt19937 gen(1);
+    std::vector<long long> sizes;
+    for (int bits = 14; bits <= 19; ++bits)
+        sizes.push_back(1LL << bits);
+    sizes.push_back(MaxInSphereCoordinate());
+    for (long long m: sizes) {
+        Delaunay3<long long> delaunay(Cube(m, 30, gen));
+        CHECK(Valid(delaunay, 8.0L * m * m * m));
+    }
+}
+
+// many cospherical points: a grid, built at once and by insertions
+void TestGrid() {
+    std::vector<Point<long long, 3>> points;
+    for (long long x = 0; x < 4; ++x)
+        for (long long y = 0; y < 4; ++y)
+            for (long long z = 0; z < 4; ++z)
+                points.push_back(Point<long long, 3>(x, y, z));
+
+    Delaunay3<long long> built(points);
+    CHECK(Valid(built, 27));
+
+    Delaunay3<long long> inserted;
+    for (const auto& p: points)
+        inserted.Insert(p);
+    CHECK(inserted.Insert(points[5]) == 5);
+    CHECK(inserted.PointsCount() == points.size());
+    CHECK(Valid(inserted, 27));
+}
+
+void TestRandomDouble() {
+    std::mt19937 gen(2);
+    std::uniform_real_distribution<double> u(-1, 1);
+    std::vector<Point<double, 3>> points;
+    for (int i = 0; i < 8; ++i)
+        points.push_back(Point<double, 3>(i & 1 ? 1.0 : -1.0, i & 2 ? 1.0 : -1.0, i & 4 ? 1.0 : -1.0));
+    for (int i = 0; i < 300; ++i)
+        points.push_back(Point<double, 3>(u(gen), u(gen), u(gen)));
+    CHECK(Valid(Delaunay3<double>(points), 8));
+}
+
+} // namespace
+
+int main() {
+    TestOrientation();
+    TestIntegerCube();
+    TestGrid();
+    TestRandomDouble();
+    return TEST_RESULT();
+}
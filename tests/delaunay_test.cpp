@@ -0,0 +1,112 @@
+#include <vector>
+#include <random>
+#include <set>
+#include "geometry/delaunay.h"
+#include "check.h"
+
+using namespace geometry;
+
+namespace {
+
+// triangles are positive and locally Delaunay, every distinct point is a vertex
+template<typename Tp>
+bool Valid(const Delaunay<Tp>& delaunay) {
+    typedef TriangleMesh<uint32_t> Mesh;
+    const Mesh& mesh = delaunay.GetMesh();
+    for (size_t t = 0; t < mesh.TrianglesCount(); ++t) {
+        const Point<Tp>& a = delaunay.GetPoint(mesh.Vertex(t, 0));
+        const Point<Tp>& b = delaunay.GetPoint(mesh.Vertex(t, 1));
+        const Point<Tp>& c = delaunay.GetPoint(mesh.Vertex(t, 2));
+        if (Orientation(a, b, c) <= 0)
+            return false;
+        for (size_t h = 3 * t; h < 3 * t + 3; ++h) {
+            size_t twin = mesh.Twin(h);
+            if (twin != Mesh::NONE && InCircle(a, b, c, delaunay.GetPoint(mesh.Origin(Mesh::Prev(twin)))) > 0)
+                return false;
+        }
+    }
+
+    std::set<Point<Tp>> vertices, points;
+    for (size_t v = 0; v < delaunay.PointsCount(); ++v) {
+        if (delaunay.IsRemoved(v))
+            continue;
+        points.insert(delaunay.GetPoint(v));
+        if (mesh.VertexEdge(v) != Mesh::NONE && !vertices.insert(delaunay.GetPoint(v)).second)
+            return false;
+    }
+    return vertices == points;
+}
+
+void TestBuild() {
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<int> u(0, 20);
+    std::vector<Point<int>> points;
+    for (int i = 0; i < 500; ++i)
+        points.push_back(Point<int>(u(gen), u(gen)));
+    Delaunay<int> delaunay(points);
+    CHECK(Valid(delaunay));
+
+    for (int v = 0; v < 100; ++v)
+        delaunay.Remove(v);
+    CHECK(Valid(delaunay));
+}
+
+// a vertex, which became a duplicate in a move, comes back, once its point is unique
+void TestMoveDuplicate() {
+    std::vector<Point<double>> points;
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j)
+            points.push_back(Point<double>(i, j));
+    points.push_back(Point<double>(1, 1));
+
+    Delaunay<double> delaunay(points);
+    size_t last = points.size() - 1;
+    CHECK(delaunay.GetMesh().VertexEdge(last) == TriangleMesh<uint32_t>::NONE);
+    CHECK(Valid(delaunay));
+
+    points[last] = Point<double>(1.5, 1.25);
+    delaunay.Move(points);
+    CHECK(delaunay.GetMesh().VertexEdge(last) != TriangleMesh<uint32_t>::NONE);
+    CHECK(Valid(delaunay));
+
+    // moves onto another vertex and away again
+    points[last] = points[6];
+    delaunay.Move(points);
+    CHECK(Valid(delaunay));
+    points[last] = Point<double>(2.5, 0.5);
+    delaunay.Move(points);
+    CHECK(Valid(delaunay));
+    CHECK(delaunay.GetMesh().VertexEdge(6) != TriangleMesh<uint32_t>::NONE);
+    CHECK(delaunay.GetMesh().VertexEdge(last) != TriangleMesh<uint32_t>::NONE);
+}
+
+// random moves on a coarse grid collide often
+void TestMoveRandom() {
+    std::mt19937 gen(2);
+    std::uniform_int_distribution<int> u(0, 10), step(-1, 1);
+    std::vector<Point<int>> points;
+    for (int i = 0; i < 60; ++i)
+        points.push_back(Point<int>(u(gen), u(gen)));
+
+    Delaunay<int> delaunay(points);
+    size_t invalid = 0;
+    for (int round = 0; round < 200; ++round) {
+        for (auto& p: points) {
+            if (gen() % 4 == 0)
+                p = Point<int>(std::max(0, std::min(10, p.x() + step(gen))),
+                               std::max(0, std::min(10, p.y() + step(gen))));
+        }
+        delaunay.Move(points, 2);
+        invalid += !Valid(delaunay);
+    }
+    CHECK(invalid == 0);
+}
+
+} // namespace
+
+int main() {
+    TestBuild();
+    TestMoveDuplicate();
+    TestMoveRandom();
+    return TEST_RESULT();
+}
@@ -0,0 +1,154 @@
+#include <vector>
+#include <random>
+#include <utility>
+#include <limits>
+#include "geometry/snap_rounding.h"
+#include "check.h"
+
+using namespace geometry;
+
+namespace {
+
+typedef std::vector<std::pair<size_t, size_t>> Segments;
+
+// the only hot pixel of two crossing segments on the unit grid
+IntPoint Crossing(const IntPoint& a, const IntPoint& b, const IntPoint& c, const IntPoint& d) {
+    SnapRounding<long long> snap(SnapGrid{0, 0, 1});
+    snap.Build({a, b, c, d}, Segments{{0, 1}, {2, 3}});
+    if (snap.Vertices().size() != 5)
+        return IntPoint(std::numeric_limits<long long>::min(), 0);
+    return snap.Vertices().back();
+}
+
+void TestFloorDiv() {
+    CHECK(detail::FloorDiv(7, 2) == 3);
+    CHECK(detail::FloorDiv(-7, 2) == -4);
+    CHECK(detail::FloorDiv(-8, 2) == -4);
+    CHECK(detail::FloorDiv(0, 5) == 0);
+    CHECK(detail::FloorDiv(-1, 5) == -1);
+    Int128 big = static_cast<Int128>(1) << 120;
+    CHECK(detail::FloorDiv(-big - 1, big) == -2);
+    CHECK(detail::FloorDiv(big - 1, big) == 0);
+}
+
+// the largest coordinates are exact bounds: one more overflows the width
+void TestMaxCoordinate() {
+    CHECK(detail::IntegerPower(3, 4) == 81);
+    CHECK(detail::IntegerPower(1LL << 31, 4) == static_cast<UInt128>(1) << 124);
+
+    CHECK(MaxOrientationCoordinate() == 1073741823);
+    CHECK(MaxInCircleCoordinate(64) == 14804);
+    CHECK(MaxInCircleCoordinate(128) == 970235263);
+    CHECK(MaxInCircleCoordinate() == 970235263);
+    CHECK(detail::MaxCoordinate(128, 48, 3) == MaxOrientation3Coordinate());
+    CHECK(detail::MaxCoordinate(128, 2304, 5) == MaxInSphereCoordinate());
+
+    struct Limit {
+        int bits;
+        unsigned coefficient;
+        int power;
+    };
+    const Limit limits[] = {{64, 8, 2}, {64, 192, 4}, {128, 192, 4}, {128, 48, 3}, {128, 2304, 5}};
+    bool exact = true;
+    for (const Limit& l: limits) {
+        long long m = detail::MaxCoordinate(l.bits, l.coefficient, l.power);
+        UInt128 bound = static_cast<UInt128>(1) << (l.bits - 1);
+        exact = exact && l.coefficient * detail::IntegerPower(m, l.power) < bound &&
+                l.coefficient * detail::IntegerPower(m + 1, l.power) >= bound;
+    }
+    CHECK(exact);
+}
+
+// intersections round to the nearest pixel center, halves go up
+void TestIntersection() {
+    const long long m = MaxOrientationCoordinate();
+    CHECK(Crossing(IntPoint(0, 0), IntPoint(3, 1), IntPoint(0, 1), IntPoint(3, 0)) == IntPoint(2, 1));
+    CHECK(Crossing(IntPoint(-3, 0), IntPoint(0, 1), IntPoint(-3, 1), IntPoint(0, 0)) == IntPoint(-1, 1));
+    // (-1.25..., -2.25...)
+    CHECK(Crossing(IntPoint(-m, -m), IntPoint(m, m - 2), IntPoint(-m, m), IntPoint(m - 7, -m)) ==
+          IntPoint(-1, -2));
+    // 1/2 + 5e-10 in both coordinates
+    CHECK(Crossing(IntPoint(-m, -3), IntPoint(m, 4), IntPoint(-5, -m), IntPoint(6, m)) == IntPoint(1, 1));
+    // parallel and touching segments have no hot pixels
+    CHECK(Crossing(IntPoint(0, 0), IntPoint(4, 4), IntPoint(1, 0), IntPoint(5, 4)).x() ==
+          std::numeric_limits<long long>::min());
+}
+
+long long Sign(long long value) {
+    return (value > 0) - (value < 0);
+}
+
+long long Orientation(const IntPoint& a, const IntPoint& b, const IntPoint& c) {
+    return Sign((b.x() - a.x()) * (c.y() - a.y()) - (b.y() - a.y()) * (c.x() - a.x()));
+}
+
+// polylines of random segments only meet at their vertices
+void TestRandom() {
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<long long> u(-20, 20);
+    size_t crossings = 0;
+    for (int iter = 0; iter < 50; ++iter) {
+        std::vector<IntPoint> points;
+        Segments segments;
+        for (size_t i = 0; i < 30; ++i) {
+            points.push_back(IntPoint(u(gen), u(gen)));
+            points.push_back(IntPoint(u(gen), u(gen)));
+            segments.push_back(std::make_pair(2 * i, 2 * i + 1));
+        }
+        SnapRounding<long long> snap(SnapGrid{0, 0, 1});
+        snap.Build(points, segments);
+
+        const auto& v = snap.Vertices();
+        std::vector<std::pair<size_t, size_t>> edges;
+        for (size_t k = 0; k + 1 < snap.Offsets().size(); ++k) {
+            CHECK(snap.Chains()[snap.Offsets()[k]] == snap.VertexOf(2 * k));
+            CHECK(snap.Chains()[snap.Offsets()[k + 1] - 1] == snap.VertexOf(2 * k + 1));
+            for (size_t i = snap.Offsets()[k]; i + 1 < snap.Offsets()[k + 1]; ++i)
+                edges.push_back(std::make_pair(snap.Chains()[i], snap.Chains()[i + 1]));
+        }
+        for (size_t i = 0; i < edges.size(); ++i) {
+            for (size_t j = i + 1; j < edges.size(); ++j) {
+                const IntPoint& a = v[edges[i].first];
+                const IntPoint& b = v[edges[i].second];
+                const IntPoint& c = v[edges[j].first];
+                const IntPoint& d = v[edges[j].second];
+                crossings += Orientation(a, b, c) * Orientation(a, b, d) < 0 &&
+                             Orientation(c, d, a) * Orientation(c, d, b) < 0;
+            }
+        }
+    }
+    CHECK(crossings == 0);
+}
+
+// integers keep their values on a dyadic grid, coordinates stay within the bound
+void TestDyadic() {
+    std::vector<Point<double>> points = {Point<double>(-3, 7), Point<double>(1000, -250), Point<double>(17, 1)};
+    SnapGrid grid = SnapGrid::Dyadic(points);
+    bool exact = true;
+    for (const auto& p: points)
+        exact = exact && grid.Unsnap(grid.Snap(p)) == p;
+    CHECK(exact);
+
+    points = {Point<double>(-3e12, 1), Point<double>(5e12, 0.5)};
+    grid = SnapGrid::Dyadic(points);
+    bool inside = true;
+    for (const auto& p: points) {
+        IntPoint s = grid.Snap(p);
+        inside = inside && std::abs(s.x()) <= MaxOrientationCoordinate() &&
+                 std::abs(s.y()) <= MaxOrientationCoordinate();
+    }
+    CHECK(inside);
+    int exponent;
+    CHECK(std::frexp(grid.resolution, &exponent) == 0.5);
+}
+
+} // namespace
+
+int main() {
+    TestFloorDiv();
+    TestMaxCoordinate();
+    TestIntersection();
+    TestRandom();
+    TestDyadic();
+    return TEST_RESULT();
+}
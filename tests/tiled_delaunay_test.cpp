@@ -0,0 +1,88 @@
+#include <vector>
+#include <random>
+#include <sstream>
+#include <string>
+#include <set>
+#include <array>
+#include <algorithm>
+#include <cstring>
+#include "geometry/tiled_delaunay.h"
+#include "check.h"
+
+using namespace geometry;
+
+namespace {
+
+typedef std::set<std::array<uint32_t, 3>> Triangles;
+
+// triangles as vertex triples starting from the least id
+Triangles Normalized(const TriangleMesh<uint32_t>& mesh) {
+    Triangles res;
+    for (size_t t = 0; t < mesh.TrianglesCount(); ++t) {
+        std::array<uint32_t, 3> v = {{mesh.Vertex(t, 0), mesh.Vertex(t, 1), mesh.Vertex(t, 2)}};
+        std::rotate(v.begin(), std::min_element(v.begin(), v.end()), v.end());
+        res.insert(v);
+    }
+    return res;
+}
+
+std::string Triangulate(const std::string& tile) {
+    std::istringstream in(tile);
+    std::ostringstream out;
+    return TriangulateTile<double>(in, out) ? out.str() : std::string();
+}
+
+void TestTiles() {
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> u(0, 100);
+    std::vector<Point<double>> points;
+    for (int i = 0; i < 3000; ++i)
+        points.push_back(Point<double>(u(gen), u(gen)));
+    Triangles expected = Normalized(Delaunay<double>(points).GetMesh());
+
+    TiledDelaunay<double> tiled(points, 3, 2, 8);
+    std::vector<std::string> results;
+    for (size_t tile = 0; tile < tiled.TilesCount(); ++tile) {
+        std::ostringstream out;
+        tiled.WriteTile(tile, out);
+        std::string bytes = out.str();
+
+        // a count beyond the input fails at its end
+        std::string hostile = bytes;
+        uint64_t count = uint64_t(1) << 58;
+        std::memcpy(&hostile[12 + sizeof(TileHeader) - sizeof(count)], &count, sizeof(count));
+        CHECK(Triangulate(hostile).empty());
+        CHECK(Triangulate(bytes.substr(0, bytes.size() - 1)).empty());
+
+        results.push_back(Triangulate(bytes));
+        CHECK(!results.back().empty());
+    }
+
+    // broken results are rejected, tile 0 is lost and its seams are stitched
+    for (size_t tile = 0; tile < results.size(); ++tile) {
+        const std::string& bytes = results[tile];
+        for (size_t field = 0; field < 2; ++field) {
+            std::string hostile = bytes;
+            uint64_t count = uint64_t(1) << 58;
+            std::memcpy(&hostile[4 + 8 * field], &count, sizeof(count));
+            std::istringstream in(hostile);
+            CHECK(!tiled.ReadResult(tile, in));
+        }
+        std::istringstream truncated(bytes.substr(0, bytes.size() - 1));
+        CHECK(!tiled.ReadResult(tile, truncated));
+
+        std::istringstream in(bytes);
+        if (tile > 0)
+            CHECK(tiled.ReadResult(tile, in));
+    }
+
+    tiled.Stitch();
+    CHECK(Normalized(tiled.GetMesh()) == expected);
+}
+
+} // namespace
+
+int main() {
+    TestTiles();
+    return TEST_RESULT();
+}
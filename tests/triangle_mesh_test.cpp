@@ -0,0 +1,121 @@
+#include <vector>
+#include <random>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include "geometry/delaunay.h"
+#include "geometry/triangle_mesh.h"
+#include "check.h"
+
+using namespace geometry;
+
+namespace {
+
+std::string Write(const TriangleMesh<uint32_t>& mesh) {
+    std::ostringstream out;
+    mesh.WriteBinary(out);
+    return out.str();
+}
+
+// reads into a mesh, which isn't empty, so a failure must clear it
+bool Read(const std::string& bytes, TriangleMesh<uint32_t>& mesh) {
+    mesh = TriangleMesh<uint32_t>(3);
+    mesh.AddTriangle(0, 1, 2);
+    std::istringstream in(bytes);
+    return mesh.ReadBinary(in);
+}
+
+std::string WithCount(std::string bytes, size_t field, uint64_t count) {
+    std::memcpy(&bytes[4 + 8 * field], &count, sizeof(count));
+    return bytes;
+}
+
+TriangleMesh<uint32_t> Sample(size_t count) {
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> u(0, 1);
+    std::vector<Point<double>> points;
+    for (size_t i = 0; i < count; ++i)
+        points.push_back(Point<double>(u(gen), u(gen)));
+    return Delaunay<double>(points).GetMesh();
+}
+
+void TestRoundTrip() {
+    TriangleMesh<uint32_t> mesh = Sample(1000);
+    TriangleMesh<uint32_t> read;
+    CHECK(Read(Write(mesh), read));
+    CHECK(read.Triangles() == mesh.Triangles());
+    CHECK(read.Twins() == mesh.Twins());
+    CHECK(read.VerticesCount() == mesh.VerticesCount());
+    bool same = true;
+    for (size_t v = 0; v < mesh.VerticesCount(); ++v)
+        same = same && read.VertexEdge(v) == mesh.VertexEdge(v);
+    CHECK(same);
+}
+
+void TestTruncated() {
+    std::string bytes = Write(Sample(10));
+    size_t accepted = 0, left = 0;
+    for (size_t size = 0; size < bytes.size(); ++size) {
+        TriangleMesh<uint32_t> mesh;
+        accepted += Read(bytes.substr(0, size), mesh);
+        left += mesh.TrianglesCount() + mesh.VerticesCount();
+    }
+    CHECK(accepted == 0);
+    CHECK(left == 0);
+}
+
+// counts far beyond the input fail at its end instead of allocating them
+void TestHostileHeader() {
+    std::string bytes = Write(Sample(10));
+    TriangleMesh<uint32_t> mesh;
+
+    std::string magic = bytes;
+    magic[0] = 'X';
+    CHECK(!Read(magic, mesh));
+    CHECK(!Read(WithCount(bytes, 0, 8), mesh));
+    CHECK(!Read(WithCount(bytes, 1, uint64_t(1) << 40), mesh));
+    CHECK(!Read(WithCount(bytes, 2, uint64_t(1) << 40), mesh));
+    CHECK(!Read(WithCount(bytes, 2, uint64_t(-1)), mesh));
+    CHECK(!Read(WithCount(bytes, 1, 3), mesh));
+    CHECK(mesh.TrianglesCount() == 0 && mesh.VerticesCount() == 0);
+
+    // 64-bit ids allow the counts, so the input ends first
+    TriangleMesh<uint64_t> wide(3);
+    wide.AddTriangle(0, 1, 2);
+    std::ostringstream out;
+    wide.WriteBinary(out);
+    for (size_t field = 1; field <= 2; ++field) {
+        std::istringstream in(WithCount(out.str(), field, uint64_t(1) << 60));
+        TriangleMesh<uint64_t> read;
+        CHECK(!read.ReadBinary(in));
+    }
+}
+
+// ids out of range are rejected
+void TestInconsistent() {
+    TriangleMesh<uint32_t> mesh(3);
+    mesh.AddTriangle(0, 1, 2);
+    std::string bytes = Write(mesh);
+
+    std::string vertex = bytes;
+    uint32_t id = 3;
+    std::memcpy(&vertex[4 + 24], &id, sizeof(id));
+    TriangleMesh<uint32_t> read;
+    CHECK(!Read(vertex, read));
+
+    std::string edge = bytes;
+    id = 7;
+    std::memcpy(&edge[bytes.size() - sizeof(id)], &id, sizeof(id));
+    CHECK(!Read(edge, read));
+    CHECK(Read(bytes, read));
+}
+
+} // namespace
+
+int main() {
+    TestRoundTrip();
+    TestTruncated();
+    TestHostileHeader();
+    TestInconsistent();
+    return TEST_RESULT();
+}